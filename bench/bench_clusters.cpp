@@ -0,0 +1,62 @@
+// assimp includes
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+// anari-sdk includes
+#include <anari/anari.h>
+// std includes
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// bridge includes
+#include "../include/bridge.h"
+#include "bench_common.h"
+
+// helide commit, BVH build and render time of a model bridged whole and split in spatial clusters of decreasing size
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: ./bench_clusters <model_path> [frames] [thread_count]" << std::endl;
+    return 1;
+  }
+  const unsigned int frames = argc > 2 ? unsigned(std::strtoul(argv[2], nullptr, 10)) : 20;
+
+  Assimp::Importer importer;
+  const aiScene* scene = importer.ReadFile(argv[1], aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices);
+  if (!scene || !scene->HasMeshes()) {
+    std::cerr << "Failed to load model: " << importer.GetErrorString() << std::endl;
+    return 1;
+  }
+  float lower[3], upper[3];
+  bench::sceneBounds(scene, lower, upper);
+
+  for (unsigned int clusterTriangles: { 0u, 1u << 22, 1u << 20, 1u << 18, 1u << 16, 1u << 14 }) {
+    ANARIDevice device = bench::newHelideDevice();
+    if (!device) {
+      std::cerr << "Failed to create helide device" << std::endl;
+      return 1;
+    }
+    assimp_anari_bridge::BridgeOptions options;
+    options.threadCount = argc > 3 ? unsigned(std::strtoul(argv[3], nullptr, 10)) : 0;
+    options.clusterTriangles = clusterTriangles;
+
+    auto start = std::chrono::steady_clock::now();
+    ANARIWorld world = assimp_anari_bridge::bridge(scene, device, options);
+    const double bridgeMilliseconds = bench::millisecondsSince(start);
+    const bench::RenderTimings timings = bench::renderWorld(device, world, lower, upper, frames);
+
+    if (clusterTriangles) {
+      std::cout << "clusters of " << clusterTriangles << " triangles";
+    } else {
+      std::cout << "whole meshes";
+    }
+    std::cout << " | bridge " << bridgeMilliseconds << " ms"
+              << " | commit " << timings.commitMilliseconds << " ms"
+              << " | first frame (build) " << timings.firstFrameMilliseconds << " ms"
+              << " | frame " << timings.frameMilliseconds << " ms" << std::endl;
+
+    anariRelease(device, world);
+    anariRelease(device, device);
+  }
+  return 0;
+}
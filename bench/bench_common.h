@@ -0,0 +1,132 @@
+#ifndef _ASSIMP_ANARI_BRIDGE_BENCH_COMMON_H_DEFINED
+#define _ASSIMP_ANARI_BRIDGE_BENCH_COMMON_H_DEFINED
+
+// assimp includes
+#include <assimp/scene.h>
+// anari-sdk includes
+#include <anari/anari.h>
+// std includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+// Helpers shared by the benchmarks rendering with helide
+
+namespace bench {
+
+  inline double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  inline void statusFunc(const void* userData, ANARIDevice device, ANARIObject source, ANARIDataType sourceType,
+                         ANARIStatusSeverity severity, ANARIStatusCode code, const char* message) {
+    if (severity == ANARI_SEVERITY_FATAL_ERROR || severity == ANARI_SEVERITY_ERROR) {
+      fprintf(stderr, "[ERROR][%p] %s\n", source, message);
+    }
+  }
+
+  // helide device, null on failure
+  inline ANARIDevice newHelideDevice() {
+    ANARILibrary library = anariLoadLibrary("helide", statusFunc, nullptr);
+    if (!library) {
+      return nullptr;
+    }
+    ANARIDevice device = anariNewDevice(library, "default");
+    anariUnloadLibrary(library);
+    return device;
+  }
+
+  // World space bounds of the vertices of a scene, placed by its node hierarchy
+  inline void sceneBounds(const aiScene* scene, float* lower, float* upper) {
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      lower[axis] = std::numeric_limits<float>::max();
+      upper[axis] = -std::numeric_limits<float>::max();
+    }
+    struct Walker {
+      static void walk(const aiScene* scene, const aiNode* node, const aiMatrix4x4& parent, float* lower, float* upper) {
+        const aiMatrix4x4 transform = parent * node->mTransformation;
+        for (unsigned int index = 0; index < node->mNumMeshes; ++index) {
+          const aiMesh* mesh = scene->mMeshes[node->mMeshes[index]];
+          for (unsigned int indexVertex = 0; indexVertex < mesh->mNumVertices; ++indexVertex) {
+            const aiVector3D position = transform * mesh->mVertices[indexVertex];
+            for (unsigned int axis = 0; axis < 3; ++axis) {
+              lower[axis] = std::min(lower[axis], position[axis]);
+              upper[axis] = std::max(upper[axis], position[axis]);
+            }
+          }
+        }
+        for (unsigned int index = 0; index < node->mNumChildren; ++index) {
+          walk(scene, node->mChildren[index], transform, lower, upper);
+        }
+      }
+    };
+    if (scene->mRootNode) {
+      Walker::walk(scene, scene->mRootNode, aiMatrix4x4(), lower, upper);
+    }
+  }
+
+  struct RenderTimings {
+    double commitMilliseconds = 0.0;      // world commit
+    double firstFrameMilliseconds = 0.0;  // first frame, includes the lazy BVH builds
+    double frameMilliseconds = 0.0;       // average of the following frames
+  };
+
+  // Commit a world and render it from outside its bounds, looking at its center
+  inline RenderTimings renderWorld(ANARIDevice device, ANARIWorld world, const float* lower, const float* upper,
+                                   unsigned int frames, unsigned int width = 1024, unsigned int height = 768) {
+    RenderTimings timings;
+    auto start = std::chrono::steady_clock::now();
+    anariCommitParameters(device, world);
+    timings.commitMilliseconds = millisecondsSince(start);
+
+    float center[3], extent = 0.0f;
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      center[axis] = 0.5f * (lower[axis] + upper[axis]);
+      extent = std::max(extent, upper[axis] - lower[axis]);
+    }
+    const float position[3] = { center[0], center[1], center[2] + 1.5f * extent };
+    const float direction[3] = { 0.0f, 0.0f, -1.0f };
+    const float up[3] = { 0.0f, 1.0f, 0.0f };
+    const float aspect = float(width) / float(height);
+    ANARICamera camera = anariNewCamera(device, "perspective");
+    anariSetParameter(device, camera, "position", ANARI_FLOAT32_VEC3, position);
+    anariSetParameter(device, camera, "direction", ANARI_FLOAT32_VEC3, direction);
+    anariSetParameter(device, camera, "up", ANARI_FLOAT32_VEC3, up);
+    anariSetParameter(device, camera, "aspect", ANARI_FLOAT32, &aspect);
+    anariCommitParameters(device, camera);
+
+    ANARIRenderer renderer = anariNewRenderer(device, "default");
+    anariCommitParameters(device, renderer);
+
+    ANARIFrame frame = anariNewFrame(device);
+    const uint32_t size[2] = { width, height };
+    const ANARIDataType colorType = ANARI_UFIXED8_RGBA_SRGB;
+    anariSetParameter(device, frame, "size", ANARI_UINT32_VEC2, size);
+    anariSetParameter(device, frame, "channel.color", ANARI_DATA_TYPE, &colorType);
+    anariSetParameter(device, frame, "world", ANARI_WORLD, &world);
+    anariSetParameter(device, frame, "camera", ANARI_CAMERA, &camera);
+    anariSetParameter(device, frame, "renderer", ANARI_RENDERER, &renderer);
+    anariCommitParameters(device, frame);
+
+    start = std::chrono::steady_clock::now();
+    anariRenderFrame(device, frame);
+    anariFrameReady(device, frame, ANARI_WAIT);
+    timings.firstFrameMilliseconds = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int index = 0; index < frames; ++index) {
+      anariRenderFrame(device, frame);
+      anariFrameReady(device, frame, ANARI_WAIT);
+    }
+    timings.frameMilliseconds = frames ? millisecondsSince(start) / frames : 0.0;
+
+    anariRelease(device, frame);
+    anariRelease(device, renderer);
+    anariRelease(device, camera);
+    return timings;
+  }
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+// assimp includes
+#include <assimp/mesh.h>
+// std includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// bridge includes
+#include "mesh_kernels.h"
+
+using namespace assimp_anari_bridge;
+
+typedef void (*FlattenKernel)(const aiFace*, uint32_t*, size_t, size_t);
+
+// Best of a few runs, in milliseconds
+static double timeKernel(FlattenKernel kernel, const aiFace* faces, size_t count, std::vector<uint32_t>& indices) {
+  double best = 1e30;
+  for (int run = 0; run < 5; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    kernel(faces, indices.data(), 0, count);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+static void runCase(const char* name, const std::vector<aiFace>& faces, const std::vector<uint32_t>& expected) {
+  struct Entry { const char* name; FlattenKernel kernel; };
+  std::vector<Entry> kernels = {
+    { "scalar (reference)", flattenTrianglesScalar },
+    { "prefetch unrolled", flattenTrianglesPrefetch },
+#if BRIDGE_HAS_GATHER_KERNEL
+    { "avx2 gather", flattenTrianglesGather },
+#endif
+    { "flattenTriangles", flattenTriangles },
+  };
+  std::cout << name << " (" << faces.size() << " faces)" << std::endl;
+  std::vector<uint32_t> indices(faces.size() * 3);
+  double reference = 0.0;
+  for (const Entry& entry: kernels) {
+    std::fill(indices.begin(), indices.end(), 0);
+    const double milliseconds = timeKernel(entry.kernel, faces.data(), faces.size(), indices);
+    if (reference == 0.0) {
+      reference = milliseconds;
+    }
+    const bool valid = indices == expected;
+    std::cout << "  " << entry.name << ": " << milliseconds << " ms, x" << reference / milliseconds
+              << (valid ? "" : "  MISMATCH") << std::endl;
+  }
+}
+
+int main(int argc, char** argv) {
+  const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<uint32_t> vertex(0, static_cast<uint32_t>(count));
+  std::vector<uint32_t> expected(count * 3);
+  for (auto& index: expected) {
+    index = vertex(random);
+  }
+
+  // One block per face like most Assimp importers, allocated in shuffled order to scatter them in the heap
+  std::vector<aiFace> scattered(count);
+  std::vector<size_t> order(count);
+  for (size_t index = 0; index < count; ++index) {
+    order[index] = index;
+  }
+  std::shuffle(order.begin(), order.end(), random);
+  for (size_t index: order) {
+    scattered[index].mNumIndices = 3;
+    scattered[index].mIndices = new unsigned int[3];
+    std::memcpy(scattered[index].mIndices, &expected[3 * index], 3 * sizeof(uint32_t));
+  }
+  runCase("scattered index blocks", scattered, expected);
+
+  // All the indices in one block
+  std::vector<unsigned int> block(expected.begin(), expected.end());
+  std::vector<aiFace> contiguous(count);
+  for (size_t index = 0; index < count; ++index) {
+    contiguous[index].mNumIndices = 3;
+    contiguous[index].mIndices = block.data() + 3 * index;
+  }
+  runCase("contiguous index blocks", contiguous, expected);
+
+  // aiFace frees its indices: hand back the borrowed block before destruction
+  for (auto& face: contiguous) {
+    face.mIndices = nullptr;
+  }
+  return 0;
+}
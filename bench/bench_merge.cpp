@@ -0,0 +1,98 @@
+// assimp includes
+#include <assimp/scene.h>
+// anari-sdk includes
+#include <anari/anari.h>
+// std includes
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+// bridge includes
+#include "../include/bridge.h"
+#include "bench_common.h"
+
+// Synthetic scene of side^3 small cube meshes, each placed by its own node on a grid, cycling over materials
+static aiScene* newCubeGrid(unsigned int side, unsigned int numMaterials) {
+  static const float corners[8][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } };
+  static const unsigned int triangles[12][3] = { { 0, 2, 1 }, { 0, 3, 2 }, { 4, 5, 6 }, { 4, 6, 7 }, { 0, 1, 5 }, { 0, 5, 4 },
+                                                 { 1, 2, 6 }, { 1, 6, 5 }, { 2, 3, 7 }, { 2, 7, 6 }, { 3, 0, 4 }, { 3, 4, 7 } };
+  const unsigned int numCubes = side * side * side;
+  aiScene* scene = new aiScene();
+  scene->mNumMaterials = numMaterials;
+  scene->mMaterials = new aiMaterial*[numMaterials];
+  for (unsigned int index = 0; index < numMaterials; ++index) {
+    scene->mMaterials[index] = new aiMaterial();
+  }
+  scene->mNumMeshes = numCubes;
+  scene->mMeshes = new aiMesh*[numCubes];
+  scene->mRootNode = new aiNode();
+  scene->mRootNode->mNumChildren = numCubes;
+  scene->mRootNode->mChildren = new aiNode*[numCubes];
+  for (unsigned int cube = 0; cube < numCubes; ++cube) {
+    aiMesh* mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mMaterialIndex = cube % numMaterials;
+    mesh->mNumVertices = 8;
+    mesh->mVertices = new aiVector3D[8];
+    for (unsigned int vertex = 0; vertex < 8; ++vertex) {
+      mesh->mVertices[vertex] = aiVector3D(0.5f * corners[vertex][0], 0.5f * corners[vertex][1], 0.5f * corners[vertex][2]);
+    }
+    mesh->mNumFaces = 12;
+    mesh->mFaces = new aiFace[12];
+    for (unsigned int face = 0; face < 12; ++face) {
+      mesh->mFaces[face].mNumIndices = 3;
+      mesh->mFaces[face].mIndices = new unsigned int[3] { triangles[face][0], triangles[face][1], triangles[face][2] };
+    }
+    scene->mMeshes[cube] = mesh;
+
+    aiNode* node = new aiNode();
+    node->mParent = scene->mRootNode;
+    node->mNumMeshes = 1;
+    node->mMeshes = new unsigned int[1] { cube };
+    aiMatrix4x4::Translation(aiVector3D(float(cube % side), float(cube / side % side), float(cube / (side * side))), node->mTransformation);
+    scene->mRootNode->mChildren[cube] = node;
+  }
+  return scene;
+}
+
+// helide commit, BVH build and render time of many small meshes bridged with and without mergeSmallMeshes
+int main(int argc, char** argv) {
+  const unsigned int side = argc > 1 ? unsigned(std::strtoul(argv[1], nullptr, 10)) : 24;
+  const unsigned int frames = argc > 2 ? unsigned(std::strtoul(argv[2], nullptr, 10)) : 20;
+  const unsigned int numMaterials = 4;
+
+  std::unique_ptr<aiScene> scene(newCubeGrid(side, numMaterials));
+  float lower[3], upper[3];
+  bench::sceneBounds(scene.get(), lower, upper);
+  std::cout << scene->mNumMeshes << " cube meshes, " << numMaterials << " materials" << std::endl;
+
+  for (bool merge: { false, true }) {
+    ANARIDevice device = bench::newHelideDevice();
+    if (!device) {
+      std::cerr << "Failed to create helide device" << std::endl;
+      return 1;
+    }
+    assimp_anari_bridge::BridgeOptions options;
+    options.threadCount = argc > 3 ? unsigned(std::strtoul(argv[3], nullptr, 10)) : 0;
+    options.mergeSmallMeshes = merge;
+    assimp_anari_bridge::BridgeReport report;
+
+    auto start = std::chrono::steady_clock::now();
+    ANARIWorld world = assimp_anari_bridge::bridge(scene.get(), device, options, &report);
+    const double bridgeMilliseconds = bench::millisecondsSince(start);
+    const bench::RenderTimings timings = bench::renderWorld(device, world, lower, upper, frames);
+
+    const size_t instances = merge ? report.mergedGeometries.size() : scene->mNumMeshes;
+    std::cout << (merge ? "merged       " : "one per mesh ")
+              << " instances " << instances
+              << " | bridge " << bridgeMilliseconds << " ms"
+              << " | commit " << timings.commitMilliseconds << " ms"
+              << " | first frame (build) " << timings.firstFrameMilliseconds << " ms"
+              << " | frame " << timings.frameMilliseconds << " ms" << std::endl;
+
+    anariRelease(device, world);
+    anariRelease(device, device);
+  }
+  return 0;
+}
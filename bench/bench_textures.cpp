@@ -0,0 +1,59 @@
+// assimp includes
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+// anari-sdk includes
+#include <anari/anari.h>
+// std includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// bridge includes
+#include "../include/bridge.h"
+#include "bench_common.h"
+
+// Texture decode throughput of a model (typically a glTF with embedded images) for increasing thread counts
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: ./bench_textures <model_path> [max_thread_count]" << std::endl;
+    return 1;
+  }
+  const unsigned int maxThreads = argc > 2 ? unsigned(std::strtoul(argv[2], nullptr, 10)) : std::max(1u, std::thread::hardware_concurrency());
+
+  Assimp::Importer importer;
+  const aiScene* scene = importer.ReadFile(argv[1], aiProcess_Triangulate);
+  if (!scene) {
+    std::cerr << "Failed to load model: " << importer.GetErrorString() << std::endl;
+    return 1;
+  }
+
+  std::vector<unsigned int> threadCounts;
+  for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+    threadCounts.push_back(threads);
+  }
+  threadCounts.push_back(maxThreads);
+
+  for (unsigned int threads: threadCounts) {
+    ANARIDevice device = bench::newHelideDevice();
+    if (!device) {
+      std::cerr << "Failed to create helide device" << std::endl;
+      return 1;
+    }
+    assimp_anari_bridge::BridgeOptions options;
+    options.threadCount = threads;
+    assimp_anari_bridge::BridgeReport report;
+    ANARIWorld world = assimp_anari_bridge::bridge(scene, device, options, &report);
+
+    std::cout << report.textureDecodeThreads << " threads"
+              << " | " << report.textureCacheMisses << " images decoded in " << report.textureDecodeMilliseconds << " ms"
+              << " | " << report.textureDecodeMegabytesPerSecond << " MB/s"
+              << " | " << report.textureCacheHits << " cache hits" << std::endl;
+
+    anariRelease(device, world);
+    anariRelease(device, device);
+  }
+  return 0;
+}
@@ -7,8 +7,284 @@
 // assimp includes
 #include <assimp/scene.h>
 
+// std includes
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace assimp_anari_bridge {
 
+  /**
+   * Conversion settings for bridge()
+   **/
+  struct BridgeOptions {
+    /**
+     * Number of threads used for the CPU-side mesh conversion (UV repacking, face flattening, array preparation).
+     * 1 keeps everything on the calling thread, 0 uses the hardware concurrency.
+     * ANARI objects are always created and committed from the calling thread, in mesh order,
+     * so the produced world does not depend on this value.
+     **/
+    unsigned int threadCount = 1;
+
+    /**
+     * Write repacked attributes (uv sets, triangle indices) directly into device-owned arrays
+     * obtained with anariMapArray() instead of staging them in temporary buffers that the device
+     * copies again. The repacking then happens at submission, split over the thread pool.
+     **/
+    bool mapDeviceArrays = false;
+
+    /**
+     * Detect meshes with byte-identical content (hashed in parallel, then compared) and convert them once:
+     * duplicates share the ANARIGeometry of their first occurrence.
+     **/
+    bool deduplicateMeshes = false;
+
+    /**
+     * Detect meshes with the same topology whose vertices only differ by a rotation, uniform scale and
+     * translation (typically transforms baked in the vertex data by exporters), and convert them once:
+     * copies share the geometry of the first mesh and carry the transform in their instances.
+     **/
+    bool instanceRigidCopies = false;
+
+    /**
+     * Accepted error of instanceRigidCopies, relative to the mesh bounding radius for positions
+     * and absolute for normals, tangents and bitangents
+     **/
+    float rigidCopyTolerance = 1e-4f;
+
+    /**
+     * Reorder the triangles of every indexed mesh along the Morton (Z-order) curve of their centroids
+     * and renumber the vertices in first use order before upload, for better device BVH build and
+     * traversal locality. Vertices referenced by no triangle are dropped.
+     **/
+    bool reorderTriangles = false;
+
+    /**
+     * Quantize the vertex attributes before upload: 16 or 8 stores normals, tangents and bitangents as
+     * FIXED16_VEC3 or FIXED8_VEC3, and also stores colors as UFIXED8_VEC4 and the uv sets lying in [0, 1]
+     * as UFIXED16_VEC2 (other uv sets stay FLOAT32_VEC2). 0 keeps every attribute in FLOAT32.
+     * The device must accept normalized fixed point vertex arrays: ANARI has no property to query it, so the
+     * bridge does not check and does not fall back to FLOAT32. Leave 0 unless the device is known to support them.
+     **/
+    unsigned int quantizationBits = 0;
+
+    /**
+     * For meshes with normals, tangents and bitangents, upload vertex.tangent as FLOAT32_VEC4 carrying the
+     * handedness in w (bitangent = w * cross(normal, tangent)) instead of the bitangents in vertex.attribute0.
+     * With quantizationBits the tangents become FIXED16_VEC4 or FIXED8_VEC4. vertex.attribute0 then holds the
+     * first uv set and the samplers read it from there; bitangents of meshes without normals are dropped.
+     **/
+    bool packTangentHandedness = false;
+
+    /**
+     * Upload only the vertex attributes the material of each mesh reads: the uv channels its textures
+     * use (AI_MATKEY_UVWSRC), tangents and bitangents when it has a normal map, colors unless it has a base
+     * color texture. The uv channels the material samples are uploaded in the free vertex.attribute slots
+     * in channel order, and its samplers read them from there; without pruning uv channel n is uploaded in
+     * vertex.attribute(n + 1), vertex.attribute(n) with packTangentHandedness.
+     **/
+    bool pruneUnusedAttributes = false;
+
+    /**
+     * Generate angle-weighted smooth normals, on the thread pool, for the triangle meshes imported without
+     * normals, instead of running aiProcess_GenSmoothNormals in Assimp. Vertices are never split: the crease
+     * angle only keeps apart vertices that already share a position, a vertex index used by faces on both
+     * sides of a hard edge gets one normal smoothed over all of them. Import with per-face vertices (no
+     * aiProcess_JoinIdenticalVertices) for hard edges to stay hard.
+     **/
+    bool generateNormals = false;
+
+    /**
+     * Largest angle in degrees between the normals merged by generateNormals across distinct vertices at the same
+     * position (same default as aiProcess_GenSmoothNormals). It only keeps such existing seams hard: it has no
+     * effect on faces sharing a vertex index, so none on meshes welded by aiProcess_JoinIdenticalVertices.
+     **/
+    float normalCreaseAngle = 175.0f;
+
+    /**
+     * Generate MikkTSpace-compatible tangents, on the thread pool, for the triangle meshes imported without tangents
+     * whose material has a normal map (using the normal map uv channel), instead of running aiProcess_CalcTangentSpace
+     * in Assimp. Generated tangents are uploaded as vertex.tangent FLOAT32_VEC4 with the handedness in w
+     * (FIXED16_VEC4 / FIXED8_VEC4 with quantizationBits), without bitangents.
+     **/
+    bool generateTangents = false;
+
+    /**
+     * Weld the vertices whose uploaded attributes are identical, drop degenerate triangles and unreferenced
+     * vertices, on the thread pool, instead of running aiProcess_JoinIdenticalVertices in Assimp.
+     * Welded meshes are uploaded from compacted streams.
+     **/
+    bool weldVertices = false;
+
+    /**
+     * Merge the small triangle meshes placed by static nodes (no animation channel on the node or its ancestors)
+     * into pre-transformed geometries, one per material, attribute layout and cell of a mergeGridResolution^3 grid
+     * over the placements, each drawn by a single identity instance. Cuts the number of instances, groups and BLAS
+     * the device has to build; BridgeReport::mergedGeometries maps merged triangles back to their meshes for picking.
+     * Merged geometries keep the triangle order of their meshes: reorderTriangles, weldVertices and clusterTriangles
+     * skip them.
+     **/
+    bool mergeSmallMeshes = false;
+
+    /**
+     * Largest number of triangles of a mesh merged by mergeSmallMeshes
+     **/
+    unsigned int mergeTriangleThreshold = 256;
+
+    /**
+     * Cells per axis of the grid splitting mergeSmallMeshes geometries, so that merged geometries stay spatially
+     * compact (1 merges everything sharing a material in one geometry)
+     **/
+    unsigned int mergeGridResolution = 4;
+
+    /**
+     * Split the meshes of more than clusterTriangles triangles into spatial clusters of at most clusterTriangles
+     * triangles (parallel binned SAH build), each uploaded as its own geometry in the group of the mesh, so that the
+     * device builds several small BVHs instead of a monolithic one. 0 keeps every mesh whole.
+     **/
+    unsigned int clusterTriangles = 0;
+
+    /**
+     * Number of simplified levels of detail generated for every triangle mesh, each one simplified from the previous
+     * with quadric error metrics on the thread pool (see lodReduction). Levels are uploaded as alternative groups that
+     * selectLevelsOfDetail() swaps into the instances listed by BridgeReport::lodInstances. The chain stops early when
+     * a mesh cannot be simplified further (borders and attribute seams are kept: weld meshes first). 0 generates none.
+     **/
+    unsigned int lodLevels = 0;
+
+    /**
+     * Triangle count of each level of detail relative to the previous level
+     **/
+    float lodReduction = 0.5f;
+
+    /**
+     * Upload the positions of every mesh relative to its first vertex and move that offset into the instance
+     * transforms, so that meshes far from the origin (georeferenced data) keep their FLOAT32 precision on the device
+     * and get tight BVH bounds. Positions are then converted instead of handed as is.
+     **/
+    bool rebaseMeshOrigins = false;
+
+    /**
+     * Express the instance transforms relative to a scene origin, the center of the scene bounds, composed in double
+     * precision. The instances are listed by BridgeReport::rebasedInstances so that setSceneOrigin() can shift the
+     * origin later (e.g. to follow the camera).
+     **/
+    bool rebaseSceneOrigin = false;
+
+    /**
+     * Directory the texture paths that are not embedded in the scene are relative to, typically the directory of the
+     * model file (empty: the working directory). Paths that do not exist there are also looked up by file name only.
+     **/
+    std::string textureDirectory;
+
+    /**
+     * Memory map the external texture files instead of reading them into buffers. Files are read and decoded on the
+     * thread pool, each file once however many materials reference it.
+     **/
+    bool mapTextureFiles = true;
+
+    /**
+     * Split the packed glTF maps into single channel UFIXED8 images: metalness (blue) and roughness (green) of the
+     * metallicRoughness texture, occlusion (red) of the occlusion texture, deinterleaved while decoding. Each sampler
+     * then binds a one byte per texel image instead of the whole RGB(A) one read through an outTransform swizzle.
+     **/
+    bool splitPackedChannels = false;
+  };
+
+  /**
+   * Axis-aligned bounding box, empty (lower > upper) until it contains a point
+   **/
+  struct Bounds {
+    float lower[3] = { 3.402823466e+38f, 3.402823466e+38f, 3.402823466e+38f };
+    float upper[3] = { -3.402823466e+38f, -3.402823466e+38f, -3.402823466e+38f };
+
+    bool empty() const { return lower[0] > upper[0]; }
+  };
+
+  /**
+   * Vertex welding of one mesh
+   **/
+  struct WeldReport {
+    unsigned int meshIndex = 0;
+    unsigned int verticesBefore = 0;
+    unsigned int verticesAfter = 0;
+    unsigned int trianglesBefore = 0;
+    unsigned int trianglesAfter = 0;
+    double milliseconds = 0.0;
+  };
+
+  /**
+   * Geometry merged from small static meshes by mergeSmallMeshes. Triangle (primitive id) t of the geometry comes
+   * from meshIndices[i] placed by nodes[i] for the last i with firstTriangles[i] <= t, as triangle t - firstTriangles[i].
+   **/
+  struct MergedGeometry {
+    unsigned int instanceIndex = 0;            // instance drawing the geometry in the world "instance" array
+    unsigned int materialIndex = 0;
+    std::vector<unsigned int> meshIndices;     // merged mesh of each placement, in triangle order
+    std::vector<const aiNode*> nodes;          // node placing it, nullptr for scenes without node hierarchy
+    std::vector<uint32_t> firstTriangles;      // first merged triangle of each placement
+  };
+
+  /**
+   * One level of detail over all the meshes, level 0 being the full resolution
+   **/
+  struct LodLevelReport {
+    unsigned int meshes = 0;       // meshes having this level
+    uint64_t triangles = 0;
+    uint64_t bytes = 0;            // size of the arrays uploaded for the level
+    double milliseconds = 0.0;     // simplification and array preparation, summed over the meshes (0 for level 0)
+  };
+
+  /**
+   * Instance whose group can be swapped between levels of detail, with retained handles
+   **/
+  struct LodInstance {
+    ANARIInstance instance = nullptr;
+    std::vector<ANARIGroup> groups;   // group of each level, full resolution first
+    float center[3] = { 0.0f, 0.0f, 0.0f };   // world space bounding sphere of the instanced mesh
+    float radius = 0.0f;
+    unsigned int level = 0;           // level currently set on the instance
+  };
+
+  /**
+   * Instance placed relative to the scene origin, with a retained handle
+   **/
+  struct RebasedInstance {
+    ANARIInstance instance = nullptr;
+    double transform[16];   // column-major transform into the scene (before the scene origin is taken out)
+  };
+
+  /**
+   * Conversion statistics filled by bridge()
+   **/
+  struct BridgeReport {
+    unsigned int deduplicatedMeshes = 0;   // meshes sharing the geometry of an identical mesh
+    uint64_t deduplicatedBytes = 0;        // array bytes not uploaded thanks to the deduplication
+    unsigned int rigidCopyMeshes = 0;      // meshes instanced as transformed copies of another mesh
+    uint64_t rigidCopyBytes = 0;           // array bytes not uploaded thanks to the rigid copy detection
+    uint64_t prunedAttributeBytes = 0;     // array bytes not uploaded because no material reads them
+    float normalQuantizationError = 0.0f;  // largest absolute component error of the quantized normals
+    float tangentQuantizationError = 0.0f; // same for tangents and bitangents
+    float colorQuantizationError = 0.0f;   // same for colors
+    float uvQuantizationError = 0.0f;      // same for uv sets
+    std::vector<WeldReport> weldedMeshes;  // one entry per welded mesh, in mesh order
+    std::vector<MergedGeometry> mergedGeometries;   // geometries built by mergeSmallMeshes
+    std::vector<LodLevelReport> lodLevels;          // with lodLevels, full resolution first
+    std::vector<LodInstance> lodInstances;          // with lodLevels, release with releaseLevelsOfDetail()
+    std::vector<Bounds> meshBounds;        // per aiMesh, in mesh space, over its uploaded vertices (empty when skipped)
+    std::vector<Bounds> instanceBounds;    // per instance of the world "instance" array, in world space
+    Bounds worldBounds;                    // union of the instance bounds
+    double sceneOrigin[3] = { 0.0, 0.0, 0.0 };      // scene point at the world origin, see rebaseSceneOrigin
+    std::vector<RebasedInstance> rebasedInstances;  // with rebaseSceneOrigin, release with releaseRebasedInstances()
+    unsigned int textureCacheHits = 0;     // samplers given an image already decoded
+    unsigned int textureCacheMisses = 0;   // images decoded
+    double textureDecodeMilliseconds = 0.0;        // wall time of the image decoding
+    unsigned int textureDecodeThreads = 0;         // threads decoding images
+    double textureDecodeMegabytesPerSecond = 0.0;  // decoded image bytes per second of textureDecodeMilliseconds
+    uint64_t textureFileBytes = 0;                 // read from external texture files
+    uint64_t textureArrayBytes = 0;                // of the image arrays, 8 bits per channel
+  };
+
   /**
    * Convert a full aiScene from Assimp to an ANARIWorld using a given ANARIDevice
    * @param[in] scene Assimp scene pointer
@@ -16,7 +292,67 @@ namespace assimp_anari_bridge {
    * @return The instance ANARIWorld built for given device
    **/
   ANARIWorld bridge(const aiScene* scene, ANARIDevice device);
-  
+
+  /**
+   * Convert a full aiScene from Assimp to an ANARIWorld using a given ANARIDevice
+   * @param[in] scene Assimp scene pointer
+   * @param[in] device ANARI device handler
+   * @param[in] options Conversion settings
+   * @param[out] report Optional conversion statistics
+   * @return The instance ANARIWorld built for given device
+   **/
+  ANARIWorld bridge(const aiScene* scene, ANARIDevice device, const BridgeOptions& options, BridgeReport* report = nullptr);
+
+  /**
+   * Convert a full aiScene from Assimp to an ANARIWorld, sharing ownership of the scene with the device.
+   * Vertex attributes (positions, normals, tangents, bitangents, colors) are handed to the device
+   * without any copy: each array keeps a reference on the scene that is dropped by its
+   * ANARIMemoryDeleter once the device releases the array, so the scene (typically obtained
+   * through Assimp::Importer::GetOrphanedScene()) outlives every array referencing it.
+   * @param[in] scene Assimp scene, shared with the device
+   * @param[in] device ANARI device handler
+   * @param[in] options Conversion settings
+   * @param[out] report Optional conversion statistics
+   * @return The instance ANARIWorld built for given device
+   **/
+  ANARIWorld bridge(std::shared_ptr<const aiScene> scene, ANARIDevice device, const BridgeOptions& options = BridgeOptions(), BridgeReport* report = nullptr);
+
+  /**
+   * Set on every instance the level of detail matching its distance to the camera, without re-bridging the scene:
+   * full resolution within detailDistance bounding radii of the mesh, then one level more each time the distance
+   * doubles. Only the instances whose level changes are updated and committed.
+   * @param[in] device ANARI device handler
+   * @param[in,out] instances BridgeReport::lodInstances
+   * @param[in] cameraPosition World space camera position (3 floats)
+   * @param[in] detailDistance Distance in bounding radii up to which the full resolution is kept
+   * @return Number of instances whose group changed
+   **/
+  unsigned int selectLevelsOfDetail(ANARIDevice device, std::vector<LodInstance>& instances, const float* cameraPosition, float detailDistance = 8.0f);
+
+  /**
+   * Release the handles retained by BridgeReport::lodInstances and clear it
+   * @param[in] device ANARI device handler
+   * @param[in,out] instances BridgeReport::lodInstances
+   **/
+  void releaseLevelsOfDetail(ANARIDevice device, std::vector<LodInstance>& instances);
+
+  /**
+   * Move the scene origin: every instance of BridgeReport::rebasedInstances gets its transform relative to the new
+   * origin, composed in double precision and committed. The world space values of the report (instance and world
+   * bounds, level of detail bounding spheres) are shifted along.
+   * @param[in] device ANARI device handler
+   * @param[in,out] report Report of a bridge() call with rebaseSceneOrigin
+   * @param[in] origin Scene point to put at the world origin (3 doubles)
+   **/
+  void setSceneOrigin(ANARIDevice device, BridgeReport& report, const double* origin);
+
+  /**
+   * Release the handles retained by BridgeReport::rebasedInstances and clear it
+   * @param[in] device ANARI device handler
+   * @param[in,out] instances BridgeReport::rebasedInstances
+   **/
+  void releaseRebasedInstances(ANARIDevice device, std::vector<RebasedInstance>& instances);
+
 }
 
 
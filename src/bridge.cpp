@@ -1,196 +1,1728 @@
 #include "bridge.h"
+#include "mesh_kernels.h"
+#include "mesh_processing.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
 
 #include <assimp/scene.h>
 #include <assimp/mesh.h>
 #include <assimp/material.h>
 #include <assimp/pbrmaterial.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <functional>
 #include <limits>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <set>
+#include <tuple>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-bool loadTexture(const aiScene* scene, ANARIDevice device, const aiMaterial* aiMaterial, const aiTextureType type, const unsigned int index, ANARISampler sampler)
+namespace {
+
+  // Ways a sampler reads an image: whole, as data or as sRGB colors, or one channel of a packed map
+  // (splitPackedChannels)
+  enum ImageView { dataView, colorView, redView, greenView, blueView, imageViewCount };
+
+  // Image decoded once per bridge() call, shared by every sampler reading it
+  struct CachedImage {
+    const aiTexture* texture = nullptr;   // embedded image, or
+    std::string file;                     // image file
+    uint64_t fileBytes = 0;               // read from file
+    std::shared_ptr<stbi_uc> pixels;   // decoded image, shared with the image arrays over it
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    bool decoded = false;        // decode attempted
+    bool sampled[imageViewCount] = {};                 // views read by the samplers
+    ANARIArray2D arrays[imageViewCount] = {};          // one per view
+    std::unique_ptr<uint8_t[]> planes[3];              // red, green and blue views, until handed to the device
+  };
+
+  const size_t noImage = size_t(-1);
+
+  // Decoded images keyed by embedded texture (the same for its "*index" and file name paths) and by content hash,
+  // so that textures embedded twice are decoded once too, or by resolved file so that each file is read once
+  struct TextureCache {
+    std::string directory;                     // external texture paths are relative to it
+    bool mapFiles = true;
+    bool mapArrays = false;                    // copy the pixels into mapped device arrays
+    std::map<const aiTexture*, size_t> byTexture;
+    std::multimap<uint64_t, size_t> byHash;    // confirmed by comparing the bytes
+    std::map<std::string, size_t> byPath;      // path of the materials -> image, noImage when not found
+    std::map<std::string, size_t> byFile;      // resolved file -> image
+    std::vector<CachedImage> images;
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    double decodeMilliseconds = 0.0;
+    uint64_t decodedBytes = 0;
+    uint64_t fileBytes = 0;
+    uint64_t arrayBytes = 0;
+  };
+
+  // Bytes of an embedded texture: the compressed file, or mWidth * mHeight texels
+  size_t textureBytes(const aiTexture* texture) {
+    return texture->mHeight == 0 ? texture->mWidth : size_t(texture->mWidth) * texture->mHeight * sizeof(aiTexel);
+  }
+
+  bool sameTexture(const aiTexture* first, const aiTexture* second) {
+    return first->mHeight == second->mHeight && textureBytes(first) == textureBytes(second) &&
+           std::memcmp(first->pcData, second->pcData, textureBytes(first)) == 0;
+  }
+
+  // 8-bit element type of a whole decoded image, sRGB encoded for color maps
+  ANARIDataType imageType(int channels, bool srgb) {
+    switch (channels) {
+      case 1: return srgb ? ANARI_UFIXED8_R_SRGB : ANARI_UFIXED8;
+      case 2: return srgb ? ANARI_UFIXED8_RA_SRGB : ANARI_UFIXED8_VEC2;
+      case 3: return srgb ? ANARI_UFIXED8_RGB_SRGB : ANARI_UFIXED8_VEC3;
+      default: return srgb ? ANARI_UFIXED8_RGBA_SRGB : ANARI_UFIXED8_VEC4;
+    }
+  }
+
+  // Texture types holding colors (sRGB encoded in glTF), the others hold data
+  bool isColorTexture(aiTextureType type) {
+    return type == aiTextureType_BASE_COLOR || type == aiTextureType_EMISSIVE;
+  }
+
+  // View of the samplers of a texture type: its color encoding, or with splitPackedChannels the channel read from the
+  // packed glTF maps (occlusion in red, roughness in green, metalness in blue)
+  ImageView samplerView(aiTextureType type, bool metallic, bool splitPackedChannels) {
+    if (splitPackedChannels && type == aiTextureType_DIFFUSE_ROUGHNESS) {
+      return metallic ? blueView : greenView;
+    }
+    if (splitPackedChannels && type == aiTextureType_AMBIENT_OCCLUSION) {
+      return redView;
+    }
+    return isColorTexture(type) ? colorView : dataView;
+  }
+
+  // Channel of a single channel view: grey images (with or without alpha) hold their color channels in the first one
+  unsigned int viewChannel(ImageView view, int channels) {
+    return channels >= 3 ? unsigned(view - redView) : 0;
+  }
+
+  typedef std::shared_ptr<stbi_uc> PixelsOwner;
+
+  // ANARIMemoryDeleter of the image arrays over stb_image memory: drop the reference held by the array,
+  // the pixels are freed with the last one
+  void releaseImagePixels(const void* userData, const void* appMemory) {
+    delete static_cast<const PixelsOwner*>(userData);
+  }
+
+  // ANARIMemoryDeleter of the single channel arrays
+  void releaseImagePlane(const void* userData, const void* appMemory) {
+    delete[] static_cast<const uint8_t*>(appMemory);
+  }
+
+  // Planes of the single channel views read by the samplers, deinterleaved from the decoded pixels; the whole image
+  // is dropped when no sampler reads it. Safe to run concurrently for different images.
+  void extractPlanes(CachedImage& image) {
+    if (image.pixels == nullptr) {
+      return;
+    }
+    const size_t count = size_t(image.width) * size_t(image.height);
+    for (unsigned int view = redView; view < imageViewCount; ++view) {
+      if (!image.sampled[view] || image.planes[view - redView]) {
+        continue;
+      }
+      if (image.channels == 1) {
+        // already a single channel
+        image.sampled[dataView] = true;
+        continue;
+      }
+      image.planes[view - redView].reset(new uint8_t[count]);
+      assimp_anari_bridge::extractChannel(image.pixels.get(), count, unsigned(image.channels), viewChannel(ImageView(view), image.channels),
+                                          image.planes[view - redView].get());
+    }
+    if (!image.sampled[dataView] && !image.sampled[colorView]) {
+      image.pixels.reset();
+    }
+  }
+
+  // Single channel array of an extracted plane, which the array takes over (or copied once into a mapped device array)
+  ANARIArray2D newPlaneArray2D(ANARIDevice device, const TextureCache& cache, CachedImage& image, ImageView view) {
+    std::unique_ptr<uint8_t[]>& plane = image.planes[view - redView];
+    if (cache.mapArrays) {
+      ANARIArray2D array = anariNewArray2D(device, nullptr, 0, 0, ANARI_UFIXED8, image.width, image.height);
+      std::memcpy(anariMapArray(device, array), plane.get(), size_t(image.width) * size_t(image.height));
+      anariUnmapArray(device, array);
+      plane.reset();
+      return array;
+    }
+    return anariNewArray2D(device, plane.release(), releaseImagePlane, nullptr, ANARI_UFIXED8, image.width, image.height);
+  }
+
+  // Image array over the decoded pixels, without a copy on our side: each array holds a reference on them, released
+  // by its deleter, so that the arrays of the sRGB and data views share one buffer. The pixels are copied once into
+  // a mapped device array with mapArrays. The cache drops its own reference after the last use.
+  ANARIArray2D newImageArray2D(ANARIDevice device, const TextureCache& cache, CachedImage& image, bool srgb, bool lastUse) {
+    const ANARIDataType type = imageType(image.channels, srgb);
+    ANARIArray2D array;
+    if (cache.mapArrays) {
+      array = anariNewArray2D(device, nullptr, 0, 0, type, image.width, image.height);
+      void* destination = anariMapArray(device, array);
+      std::memcpy(destination, image.pixels.get(), size_t(image.width) * size_t(image.height) * size_t(image.channels));
+      anariUnmapArray(device, array);
+    } else {
+      array = anariNewArray2D(device, image.pixels.get(), releaseImagePixels, new PixelsOwner(image.pixels), type, image.width, image.height);
+    }
+    if (lastUse) {
+      image.pixels.reset();
+    }
+    return array;
+  }
+
+  // Image of an embedded texture in the cache, added undecoded the first time
+  size_t addImage(TextureCache& cache, const aiTexture* texture) {
+    auto found = cache.byTexture.find(texture);
+    if (found != cache.byTexture.end()) {
+      return found->second;
+    }
+    const uint64_t hash = assimp_anari_bridge::hashBytes(texture->pcData, textureBytes(texture), 0);
+    auto range = cache.byHash.equal_range(hash);
+    for (auto candidate = range.first; candidate != range.second; ++candidate) {
+      if (sameTexture(cache.images[candidate->second].texture, texture)) {
+        cache.byTexture[texture] = candidate->second;
+        return candidate->second;
+      }
+    }
+    CachedImage image;
+    image.texture = texture;
+    cache.byTexture[texture] = cache.images.size();
+    cache.byHash.insert({ hash, cache.images.size() });
+    cache.images.push_back(std::move(image));
+    return cache.images.size() - 1;
+  }
+
+  // File of a texture path: relative paths are taken from the directory, and paths that do not exist (often
+  // absolute paths of the authoring machine, or with Windows separators) fall back to their file name in it
+  std::string resolveTexturePath(const std::string& directory, std::string path) {
+    namespace fs = std::filesystem;
+    std::replace(path.begin(), path.end(), '\\', '/');
+    const fs::path base = directory.empty() ? fs::path(".") : fs::path(directory);
+    fs::path file(path);
+    if (file.is_relative()) {
+      file = base / file;
+    }
+    std::error_code error;
+    if (!fs::is_regular_file(file, error)) {
+      file = base / fs::path(path).filename();
+      if (!fs::is_regular_file(file, error)) {
+        return std::string();
+      }
+    }
+    const fs::path canonical = fs::weakly_canonical(file, error);
+    return error ? file.lexically_normal().string() : canonical.string();
+  }
+
+  // Image of an external texture in the cache, added undecoded the first time, noImage when the file is not found
+  size_t addFile(TextureCache& cache, const std::string& path) {
+    const std::string file = resolveTexturePath(cache.directory, path);
+    if (file.empty()) {
+      std::cerr << "texture file " << path << " not found" << std::endl;
+      return noImage;
+    }
+    auto found = cache.byFile.find(file);
+    if (found != cache.byFile.end()) {
+      return found->second;
+    }
+    CachedImage image;
+    image.file = file;
+    cache.byFile[file] = cache.images.size();
+    cache.images.push_back(std::move(image));
+    return cache.images.size() - 1;
+  }
+
+  // Image read by a texture path of a material: embedded texture or external file
+  size_t addTexture(const aiScene* scene, TextureCache& cache, const char* path) {
+    if (const aiTexture* texture = scene->GetEmbeddedTexture(path)) {
+      return addImage(cache, texture);
+    }
+    auto found = cache.byPath.find(path);
+    if (found != cache.byPath.end()) {
+      return found->second;
+    }
+    return cache.byPath[path] = addFile(cache, path);
+  }
+
+  // Decode a compressed image (the vertical flip is set per thread, stbi_set_flip_vertically_on_load() is process-wide)
+  void decodeMemory(CachedImage& image, const unsigned char* data, size_t size, const std::string& name) {
+    stbi_set_flip_vertically_on_load_thread(1);
+    image.pixels.reset(stbi_load_from_memory(data, int(size), &image.width, &image.height, &image.channels, 0), stbi_image_free);
+    if (image.pixels == nullptr) {
+      std::cerr << "cannot decode texture " + name + ": " + stbi_failure_reason() + "\n";
+    }
+  }
+
+  // Decode an embedded texture, or read and decode an image file (memory mapped when the cache maps files).
+  // Safe to run concurrently for different images.
+  void decodeImage(CachedImage& image, bool mapFiles) {
+    image.decoded = true;
+    if (image.texture == nullptr) {
+      const assimp_anari_bridge::MappedFile file(image.file, mapFiles);
+      if (!file.valid()) {
+        std::cerr << "cannot read texture file " + image.file + "\n";
+        return;
+      }
+      image.fileBytes = file.size();
+      decodeMemory(image, file.data(), file.size(), image.file);
+      return;
+    }
+    const aiTexture* texture = image.texture;
+    if (texture->mHeight != 0) {
+      std::cerr << "uncompressed embedded texture " + std::string(texture->mFilename.C_Str()) + " not supported\n";
+      return;
+    }
+    decodeMemory(image, reinterpret_cast<const unsigned char*>(texture->pcData), texture->mWidth, texture->mFilename.C_Str());
+  }
+
+  // Read and decode every image not decoded yet, one per task on the pool, so that file reads overlap each other
+  // and the decoding of the images already read
+  void decodeImages(assimp_anari_bridge::ThreadPool& pool, TextureCache& cache) {
+    std::vector<size_t> pending;
+    for (size_t index = 0; index < cache.images.size(); ++index) {
+      if (!cache.images[index].decoded) {
+        pending.push_back(index);
+      }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(pending.size(), [&](size_t index) {
+      decodeImage(cache.images[pending[index]], cache.mapFiles);
+      extractPlanes(cache.images[pending[index]]);
+    });
+    cache.decodeMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    for (size_t index: pending) {
+      const CachedImage& image = cache.images[index];
+      cache.decodedBytes += uint64_t(image.width) * uint64_t(image.height) * uint64_t(image.channels);
+      cache.fileBytes += image.fileBytes;
+    }
+  }
+
+  // Array of a view of a decoded image, created on first use from the device thread
+  ANARIArray2D cachedImage(ANARIDevice device, TextureCache& cache, size_t index, ImageView view) {
+    CachedImage& image = cache.images[index];
+    if (view >= redView && image.decoded && image.channels == 1) {
+      view = dataView;
+    }
+    image.sampled[view] = true;
+    if (image.arrays[view]) {
+      ++cache.hits;
+      return image.arrays[view];
+    }
+    ++cache.misses;
+    if (!image.decoded) {
+      // not collected up front
+      const auto start = std::chrono::steady_clock::now();
+      decodeImage(image, cache.mapFiles);
+      cache.decodeMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      cache.decodedBytes += uint64_t(image.width) * uint64_t(image.height) * uint64_t(image.channels);
+      cache.fileBytes += image.fileBytes;
+      if (view >= redView && image.channels == 1) {
+        view = dataView;
+        image.sampled[view] = true;
+      }
+    }
+    if (view >= redView) {
+      // not collected up front
+      extractPlanes(image);
+      if (image.planes[view - redView]) {
+        image.arrays[view] = newPlaneArray2D(device, cache, image, view);
+        anariCommitParameters(device, image.arrays[view]);
+        cache.arrayBytes += uint64_t(image.width) * uint64_t(image.height);
+        std::cerr << "loaded image texture dims : " << image.width << "," << image.height << " channel : "
+                  << viewChannel(view, image.channels) << " of " << image.channels << std::endl;
+      }
+      return image.arrays[view];
+    }
+    if (image.pixels) {
+      // the pixels are still needed when the image is also read the other way
+      const ImageView other = view == colorView ? dataView : colorView;
+      const bool lastUse = !image.sampled[other] || image.arrays[other] != nullptr;
+      image.arrays[view] = newImageArray2D(device, cache, image, view == colorView, lastUse);
+      anariCommitParameters(device, image.arrays[view]);
+      cache.arrayBytes += uint64_t(image.width) * uint64_t(image.height) * uint64_t(image.channels);
+      std::cerr << "loaded image texture dims : " << image.width << "," << image.height << " channels : " << image.channels
+                << (view == colorView ? " (sRGB)" : "") << std::endl;
+    }
+    return image.arrays[view];
+  }
+
+  void releaseTextureCache(ANARIDevice device, TextureCache& cache) {
+    for (const CachedImage& image: cache.images) {
+      for (ANARIArray2D array: image.arrays) {
+        if (array) {
+          anariRelease(device, array);
+        }
+      }
+    }
+    cache.images.clear();
+    cache.byTexture.clear();
+    cache.byHash.clear();
+    cache.byPath.clear();
+    cache.byFile.clear();
+  }
+
+  // Vertex attributes read by the samplers and parameters of a material
+  struct AttributeUsage {
+    bool uvChannels[AI_MAX_NUMBER_OF_TEXTURECOORDS] = {};
+    int uvAttributes[AI_MAX_NUMBER_OF_TEXTURECOORDS];   // vertex.attribute slot of each uv channel, -1 when not uploaded
+    bool tangents = false;   // tangents and bitangents, for normal mapping
+    bool colors = false;     // when no base color texture replaces them
+    int normalMapChannel = -1;
+
+    AttributeUsage() {
+      std::fill(uvAttributes, uvAttributes + AI_MAX_NUMBER_OF_TEXTURECOORDS, -1);
+    }
+  };
+
+  // Texture types the material conversion turns into samplers, keep in sync with bridgeScene()
+  const aiTextureType sampledTextureTypes[] = {
+    aiTextureType_BASE_COLOR, aiTextureType_DIFFUSE_ROUGHNESS, aiTextureType_NORMALS, aiTextureType_EMISSIVE,
+    aiTextureType_AMBIENT_OCCLUSION, aiTextureType_SPECULAR, aiTextureType_CLEARCOAT
+  };
+
+  // Binding table of the uv channels, shared by the uv set upload and the samplers. attribute0 carries the
+  // bitangents unless packTangentHandedness. Without pruning every channel keeps a fixed slot, with it the
+  // channels the material samples take the free slots in order.
+  AttributeUsage materialAttributeUsage(const aiMaterial* material, const assimp_anari_bridge::BridgeOptions& options) {
+    AttributeUsage usage;
+    for (aiTextureType type: sampledTextureTypes) {
+      for (unsigned int index = 0; index < material->GetTextureCount(type); ++index) {
+        int channel = 0;
+        material->Get(AI_MATKEY_UVWSRC(type, index), channel);
+        if (channel >= 0 && channel < AI_MAX_NUMBER_OF_TEXTURECOORDS) {
+          usage.uvChannels[channel] = true;
+        }
+      }
+    }
+    usage.tangents = material->GetTextureCount(aiTextureType_NORMALS) > 0;
+    if (usage.tangents) {
+      usage.normalMapChannel = 0;
+      material->Get(AI_MATKEY_UVWSRC(aiTextureType_NORMALS, 0), usage.normalMapChannel);
+    }
+    usage.colors = material->GetTextureCount(aiTextureType_BASE_COLOR) == 0;
+    int slot = options.packTangentHandedness ? 0 : 1;
+    for (unsigned int channel = 0; channel < AI_MAX_NUMBER_OF_TEXTURECOORDS && slot < 4; ++channel) {
+      if (usage.uvChannels[channel] || !options.pruneUnusedAttributes) {
+        usage.uvAttributes[channel] = slot++;
+      }
+    }
+    return usage;
+  }
+
+}
+
+bool loadTexture(const aiScene* scene, ANARIDevice device, TextureCache& textures, const AttributeUsage& usage, const aiMaterial* aiMaterial, const aiTextureType type, const unsigned int index, ANARISampler sampler, ImageView view)
 {
   aiString path;
 
-  if(aiMaterial->GetTexture(type, index, &path, NULL, NULL, NULL, NULL, NULL) == AI_SUCCESS)
-  {
-    int imageWidth, imageHeight, imageBPP;
-    imageWidth = imageHeight = imageBPP = 0;
-    const aiTexture* aiTexture = scene->GetEmbeddedTexture(path.C_Str());
-    if(aiTexture)
-    {
-      stbi_set_flip_vertically_on_load(1);
+  if(aiMaterial->GetTexture(type, index, &path, NULL, NULL, NULL, NULL, NULL) == AI_SUCCESS)
+  {
+    // read the uv set from the vertex.attribute slot its channel is uploaded in
+    int channel = 0;
+    aiMaterial->Get(AI_MATKEY_UVWSRC(type, index), channel);
+    if(channel < 0 || channel >= AI_MAX_NUMBER_OF_TEXTURECOORDS || usage.uvAttributes[channel] < 0)
+    {
+      std::cerr << "no vertex.attribute slot left for uv channel " << channel << " of texture " << path.C_Str() << std::endl;
+      return false;
+    }
+    const std::string attribute = "attribute" + std::to_string(usage.uvAttributes[channel]);
+
+    const size_t imageIndex = addTexture(scene, textures, path.C_Str());
+    if(imageIndex != noImage)
+    {
+      ANARIArray2D image = cachedImage(device, textures, imageIndex, view);
+      if(image == nullptr)
+        return false;
+      anariSetParameter(device, sampler, "image", ANARI_ARRAY2D, &image);
+      anariSetParameter(device, sampler, "inAttribute", ANARI_STRING, attribute.c_str());
+      anariSetParameter(device, sampler, "filter", ANARI_STRING, "linear");
+      anariSetParameter(device, sampler, "wrapMode1", ANARI_STRING, "repeat");
+      anariSetParameter(device, sampler, "wrapMode2", ANARI_STRING, "repeat");
+
+      anariCommitParameters(device, sampler);
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+
+  typedef std::shared_ptr<const aiScene> SceneOwner;
+
+  // ANARIMemoryDeleter of the arrays referencing aiScene memory: drop the reference held by the array
+  void releaseSceneReference(const void* userData, const void* appMemory) {
+    delete static_cast<const SceneOwner*>(userData);
+  }
+
+  // Array over memory owned by the aiScene: shared with the device when we hold the scene, copied otherwise
+  ANARIArray1D newSceneArray1D(ANARIDevice device, const SceneOwner& owner, const void* appMemory, ANARIDataType type, uint64_t count) {
+    if (!owner) {
+      return anariNewArray1D(device, appMemory, 0, 0, type, count);
+    }
+    return anariNewArray1D(device, appMemory, releaseSceneReference, new SceneOwner(owner), type, count);
+  }
+
+  // Largest quantization error per attribute kind, updated concurrently by the array fills
+  struct QuantizationErrors {
+    std::atomic<float> normal{ 0.0f };
+    std::atomic<float> tangent{ 0.0f };
+    std::atomic<float> color{ 0.0f };
+    std::atomic<float> uv{ 0.0f };
+  };
+
+  void atomicMax(std::atomic<float>& target, float value) {
+    float current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Embedded textures and image files read by the samplers of every material
+  void collectTextures(const aiScene* scene, bool splitPackedChannels, TextureCache& cache) {
+    for (unsigned int indexMaterial = 0; indexMaterial < scene->mNumMaterials; ++indexMaterial) {
+      const aiMaterial* material = scene->mMaterials[indexMaterial];
+      for (aiTextureType type: sampledTextureTypes) {
+        for (unsigned int index = 0; index < material->GetTextureCount(type); ++index) {
+          aiString path;
+          if (material->GetTexture(type, index, &path, NULL, NULL, NULL, NULL, NULL) != AI_SUCCESS) {
+            continue;
+          }
+          const size_t image = addTexture(scene, cache, path.C_Str());
+          if (image != noImage) {
+            cache.images[image].sampled[samplerView(type, true, splitPackedChannels)] = true;
+            cache.images[image].sampled[samplerView(type, false, splitPackedChannels)] = true;
+          }
+        }
+      }
+    }
+  }
+
+  bool sameUvAttributes(const AttributeUsage& first, const AttributeUsage& second) {
+    return std::equal(first.uvAttributes, first.uvAttributes + AI_MAX_NUMBER_OF_TEXTURECOORDS, second.uvAttributes);
+  }
+
+  bool sameUsage(const AttributeUsage& first, const AttributeUsage& second) {
+    return first.tangents == second.tangents && first.colors == second.colors && first.normalMapChannel == second.normalMapChannel &&
+           std::equal(first.uvChannels, first.uvChannels + AI_MAX_NUMBER_OF_TEXTURECOORDS, second.uvChannels) &&
+           sameUvAttributes(first, second);
+  }
+
+  // State shared by the conversion steps of one bridge() call
+  struct ConversionContext {
+    ANARIDevice device;
+    SceneOwner owner;
+    assimp_anari_bridge::ThreadPool& pool;
+    const assimp_anari_bridge::BridgeOptions& options;
+    uint64_t geometryMaxIndex;
+    QuantizationErrors& quantizationErrors;
+    const std::vector<AttributeUsage>& attributeUsage;   // per material
+  };
+
+  // Attributes read by the material of a mesh
+  const AttributeUsage& materialUsage(const ConversionContext& context, const aiMesh* mesh) {
+    static const AttributeUsage noUsage;
+    return mesh->mMaterialIndex < context.attributeUsage.size() ? context.attributeUsage[mesh->mMaterialIndex] : noUsage;
+  }
+
+  // Attributes kept by the material-driven pruning, nullptr when every attribute is uploaded
+  const AttributeUsage* usageOf(const ConversionContext& context, const aiMesh* mesh) {
+    return context.options.pruneUnusedAttributes ? &materialUsage(context, mesh) : nullptr;
+  }
+
+  // Writes the elements [begin, end) of an array, destination points to element 0
+  typedef std::function<void(void* destination, size_t begin, size_t end)> ArrayFill;
+
+  // Number of elements converted per task when an array conversion is split over the pool
+  const size_t conversionGrain = 1 << 16;
+
+  // Bounds of positions, one per conversionGrain range, grown by the task converting the range then reduced
+  typedef std::shared_ptr<std::vector<assimp_anari_bridge::Bounds>> RangeBounds;
+
+  RangeBounds newRangeBounds(uint64_t count) {
+    return std::make_shared<std::vector<assimp_anari_bridge::Bounds>>((count + conversionGrain - 1) / conversionGrain);
+  }
+
+  void growBounds(assimp_anari_bridge::Bounds& bounds, const assimp_anari_bridge::Bounds& other) {
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      bounds.lower[axis] = std::min(bounds.lower[axis], other.lower[axis]);
+      bounds.upper[axis] = std::max(bounds.upper[axis], other.upper[axis]);
+    }
+  }
+
+  // Positions handed as is have no fill: SIMD min/max over parallel ranges, the only pass over them
+  void growRangeBounds(const aiVector3D* points, size_t count, assimp_anari_bridge::ThreadPool& pool, std::vector<assimp_anari_bridge::Bounds>& ranges) {
+    pool.parallelForRange(count, conversionGrain, [&](size_t begin, size_t end) {
+      assimp_anari_bridge::Bounds& bounds = ranges[begin / conversionGrain];
+      assimp_anari_bridge::growBounds(points + begin, end - begin, bounds.lower, bounds.upper);
+    });
+  }
+
+  assimp_anari_bridge::Bounds reduceBounds(const std::vector<assimp_anari_bridge::Bounds>& ranges) {
+    assimp_anari_bridge::Bounds bounds;
+    for (const assimp_anari_bridge::Bounds& range: ranges) {
+      growBounds(bounds, range);
+    }
+    return bounds;
+  }
+
+  // Bounds of points
+  assimp_anari_bridge::Bounds pointBounds(const aiVector3D* points, size_t count, assimp_anari_bridge::ThreadPool& pool) {
+    std::vector<assimp_anari_bridge::Bounds> ranges((count + conversionGrain - 1) / conversionGrain);
+    growRangeBounds(points, count, pool, ranges);
+    return reduceBounds(ranges);
+  }
+
+  // Alternative conversion of a quantized array, used when the largest error of the quantized fill exceeds tolerance
+  // (uv sets outside [0, 1] do not fit UFIXED16). Checked after the fill pass, so that only the arrays falling back
+  // are read twice.
+  struct QuantizedFallback {
+    ANARIDataType type;
+    size_t elementSize;
+    ArrayFill fill;
+    float tolerance;
+    std::atomic<float> error{ 0.0f };   // largest error of the quantized fill
+    std::atomic<float>* reported;       // where the error goes when the quantized array is kept
+  };
+
+  // One geometry parameter array, created at submission
+  struct PreparedArray {
+    std::string parameter;
+    ANARIDataType type;
+    size_t elementSize;
+    uint64_t count;
+    const void* sceneMemory = nullptr;   // aiScene memory handed as is
+    ArrayFill fill;                      // otherwise converted by fill, at preparation or straight into the mapped array
+    std::vector<unsigned char> staged;   // fill output when arrays are not mapped
+    std::vector<unsigned char>* generated = nullptr;   // buffer computed by the bridge, taken as staged instead of running fill
+    std::shared_ptr<QuantizedFallback> fallback;       // when the quantized fill may not fit its format
+    RangeBounds bounds;                                // vertex.position: bounds of the uploaded positions
+  };
+
+  struct PreparedGeometry {
+    std::vector<PreparedArray> arrays;
+  };
+
+  // CPU-side result of converting one aiMesh, ready to be handed to the device
+  struct PreparedMesh {
+    const aiMesh* mesh = nullptr;
+    bool skipped = true;
+    std::vector<PreparedGeometry> geometries;   // several when the mesh is split to fit the device index limit
+    uint64_t prunedBytes = 0;                   // attribute bytes left out by the material-driven pruning
+    std::vector<unsigned char> generatedNormals;   // mNumVertices aiVector3D when the bridge generates the normals
+    std::vector<unsigned char> generatedTangents;  // mNumVertices FLOAT32_VEC4 when the bridge generates the tangents
+    bool welded = false;
+    assimp_anari_bridge::WeldReport weld;
+    std::vector<std::vector<PreparedGeometry>> lods;   // simplified levels of detail, finest first
+    std::vector<assimp_anari_bridge::LodLevelReport> lodReports;   // full resolution first, then one per level of lods
+  };
+
+  // Direction arrays of a mesh, from the aiMesh or generated by the bridge
+  struct VertexSources {
+    const aiVector3D* normals;
+    const aiVector3D* tangents;
+    const aiVector3D* bitangents;
+    std::vector<unsigned char>* generatedNormals = nullptr;
+    std::vector<unsigned char>* generatedTangents = nullptr;   // FLOAT32_VEC4 tangents with handedness, replace the three above
+    bool rebased = false;                                      // positions uploaded relative to origin
+    aiVector3D origin = aiVector3D(0.0f, 0.0f, 0.0f);
+  };
+
+  // Per-vertex attribute of an aiMesh, used as is, quantized or generated
+  struct VertexAttribute {
+    const char* parameter;
+    ANARIDataType type;
+    size_t elementSize;
+    const void* source;
+    unsigned int components = 0;                  // floats quantized per vertex, 0 when used as is
+    size_t sourceStride = 0;                      // floats per source vertex
+    assimp_anari_bridge::NormalizedFormat format = assimp_anari_bridge::NormalizedFormat::SNORM16;
+    std::atomic<float>* error = nullptr;          // where the quantization error is accumulated
+    const aiVector3D* normals = nullptr;          // tangent packing: frame of the handedness sign
+    const aiVector3D* bitangents = nullptr;
+    size_t numSourceVertices = 0;
+    std::vector<unsigned char>* generated = nullptr;   // float data generated by the bridge, source points into it
+    bool points = false;                               // positions, bounded by their fill
+    bool rebased = false;                              // positions minus origin
+    float origin[3] = { 0.0f, 0.0f, 0.0f };
+  };
+
+  // Attributes not handed as is: quantized, packed tangents, generated or rebased
+  bool isConverted(const VertexAttribute& attribute) {
+    return attribute.components != 0 || attribute.bitangents != nullptr || attribute.generated != nullptr || attribute.rebased;
+  }
+
+  VertexAttribute floatAttribute(const char* parameter, ANARIDataType type, size_t elementSize, const void* source) {
+    VertexAttribute attribute;
+    attribute.parameter = parameter;
+    attribute.type = type;
+    attribute.elementSize = elementSize;
+    attribute.source = source;
+    return attribute;
+  }
+
+  // Unit vectors as FIXED16_VEC3 or FIXED8_VEC3
+  VertexAttribute directionAttribute(const ConversionContext& context, const char* parameter, const aiVector3D* source, std::atomic<float>& error) {
+    if (context.options.quantizationBits == 0) {
+      return floatAttribute(parameter, ANARI_FLOAT32_VEC3, sizeof(aiVector3D), source);
+    }
+    const bool wide = context.options.quantizationBits > 8;
+    VertexAttribute attribute = floatAttribute(parameter, wide ? ANARI_FIXED16_VEC3 : ANARI_FIXED8_VEC3, wide ? 3 * sizeof(int16_t) : 3 * sizeof(int8_t), source);
+    attribute.components = 3;
+    attribute.sourceStride = 3;
+    attribute.format = wide ? assimp_anari_bridge::NormalizedFormat::SNORM16 : assimp_anari_bridge::NormalizedFormat::SNORM8;
+    attribute.error = &error;
+    return attribute;
+  }
+
+  // Tangents with the bitangent handedness in w, as FLOAT32_VEC4 or FIXED16_VEC4 / FIXED8_VEC4
+  VertexAttribute packedTangentAttribute(const ConversionContext& context, const aiMesh* mesh, const VertexSources& sources) {
+    VertexAttribute attribute = directionAttribute(context, "vertex.tangent", sources.tangents, context.quantizationErrors.tangent);
+    if (attribute.components) {
+      const bool wide = attribute.format == assimp_anari_bridge::NormalizedFormat::SNORM16;
+      attribute.type = wide ? ANARI_FIXED16_VEC4 : ANARI_FIXED8_VEC4;
+      attribute.elementSize = wide ? 4 * sizeof(int16_t) : 4 * sizeof(int8_t);
+      attribute.components = 4;
+    } else {
+      attribute.type = ANARI_FLOAT32_VEC4;
+      attribute.elementSize = 4 * sizeof(float);
+    }
+    attribute.normals = sources.normals;
+    attribute.bitangents = sources.bitangents;
+    attribute.numSourceVertices = mesh->mNumVertices;
+    return attribute;
+  }
+
+  // Tangents generated with their handedness, as FLOAT32_VEC4 or FIXED16_VEC4 / FIXED8_VEC4
+  VertexAttribute generatedTangentAttribute(const ConversionContext& context, const VertexSources& sources) {
+    const void* tangents = sources.generatedTangents->data();
+    if (context.options.quantizationBits == 0) {
+      VertexAttribute attribute = floatAttribute("vertex.tangent", ANARI_FLOAT32_VEC4, 4 * sizeof(float), tangents);
+      attribute.generated = sources.generatedTangents;
+      return attribute;
+    }
+    const bool wide = context.options.quantizationBits > 8;
+    VertexAttribute attribute = floatAttribute("vertex.tangent", wide ? ANARI_FIXED16_VEC4 : ANARI_FIXED8_VEC4, wide ? 4 * sizeof(int16_t) : 4 * sizeof(int8_t), tangents);
+    attribute.components = 4;
+    attribute.sourceStride = 4;
+    attribute.format = wide ? assimp_anari_bridge::NormalizedFormat::SNORM16 : assimp_anari_bridge::NormalizedFormat::SNORM8;
+    attribute.error = &context.quantizationErrors.tangent;
+    return attribute;
+  }
+
+  std::vector<VertexAttribute> vertexAttributes(const ConversionContext& context, const aiMesh* mesh, const VertexSources& sources) {
+    QuantizationErrors& errors = context.quantizationErrors;
+    std::vector<VertexAttribute> attributes;
+    attributes.push_back(floatAttribute("vertex.position", ANARI_FLOAT32_VEC3, sizeof(aiVector3D), mesh->mVertices));
+    attributes.back().points = true;
+    if (sources.rebased) {
+      attributes.back().rebased = true;
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        attributes.back().origin[axis] = sources.origin[axis];
+      }
+    }
+    if (sources.normals) {
+      attributes.push_back(directionAttribute(context, "vertex.normal", sources.normals, errors.normal));
+      if (attributes.back().components == 0) {
+        attributes.back().generated = sources.generatedNormals;
+      }
+    }
+    const AttributeUsage* usage = usageOf(context, mesh);
+    if (usage && !usage->tangents) {
+      // no normal map
+    } else if (sources.generatedTangents) {
+      attributes.push_back(generatedTangentAttribute(context, sources));
+    } else if (context.options.packTangentHandedness && sources.normals && sources.tangents && sources.bitangents) {
+      attributes.push_back(packedTangentAttribute(context, mesh, sources));
+    } else {
+      if (sources.tangents) {
+        attributes.push_back(directionAttribute(context, "vertex.tangent", sources.tangents, errors.tangent));
+      }
+      // with packTangentHandedness attribute0 holds uv set 0: bitangents that cannot be packed are dropped
+      if (sources.bitangents && !context.options.packTangentHandedness) {
+        attributes.push_back(directionAttribute(context, "vertex.attribute0", sources.bitangents, errors.tangent));
+      }
+    }
+    if (mesh->mColors[0] && (!usage || usage->colors)) {
+      if (context.options.quantizationBits == 0) {
+        attributes.push_back(floatAttribute("vertex.color", ANARI_FLOAT32_VEC4, sizeof(aiColor4D), mesh->mColors[0]));
+      } else {
+        VertexAttribute color = floatAttribute("vertex.color", ANARI_UFIXED8_VEC4, 4 * sizeof(uint8_t), mesh->mColors[0]);
+        color.components = 4;
+        color.sourceStride = 4;
+        color.format = assimp_anari_bridge::NormalizedFormat::UNORM8;
+        color.error = &errors.color;
+        attributes.push_back(color);
+      }
+    }
+    return attributes;
+  }
+
+  // Quantize [begin, end) vertices of an attribute stored as stride floats per vertex, of which the first
+  // components are kept. Vertices are read through vertices when given (mesh chunks), in blocks gathered on the stack.
+  void quantizeVertices(const float* source, size_t stride, size_t components, const uint32_t* vertices,
+                        assimp_anari_bridge::NormalizedFormat format, void* destination, size_t begin, size_t end, std::atomic<float>& error) {
+    unsigned char* output = static_cast<unsigned char*>(destination);
+    const size_t outputStride = components * assimp_anari_bridge::normalizedSize(format);
+    float maxError = 0.0f;
+    if (vertices == nullptr && stride == components) {
+      maxError = assimp_anari_bridge::quantizeNormalized(source + begin * stride, output + begin * outputStride, (end - begin) * components, format);
+    } else {
+      const size_t blockSize = 256;
+      float block[blockSize * 4];
+      for (size_t blockStart = begin; blockStart < end; blockStart += blockSize) {
+        const size_t blockEnd = std::min(end, blockStart + blockSize);
+        for (size_t indexVertex = blockStart; indexVertex < blockEnd; ++indexVertex) {
+          const size_t sourceVertex = vertices ? vertices[indexVertex] : indexVertex;
+          std::memcpy(block + (indexVertex - blockStart) * components, source + sourceVertex * stride, components * sizeof(float));
+        }
+        maxError = std::max(maxError, assimp_anari_bridge::quantizeNormalized(block, output + blockStart * outputStride, (blockEnd - blockStart) * components, format));
+      }
+    }
+    atomicMax(error, maxError);
+  }
+
+  ArrayFill quantizedFill(const VertexAttribute& attribute, const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk) {
+    const float* source = static_cast<const float*>(attribute.source);
+    const size_t stride = attribute.sourceStride;
+    const size_t components = attribute.components;
+    const assimp_anari_bridge::NormalizedFormat format = attribute.format;
+    std::atomic<float>* error = attribute.error;
+    return [source, stride, components, chunk, format, error](void* destination, size_t begin, size_t end) {
+      quantizeVertices(source, stride, components, chunk ? chunk->vertices.data() : nullptr, format, destination, begin, end, *error);
+    };
+  }
+
+  ArrayFill packedTangentFill(const VertexAttribute& attribute, const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk) {
+    const aiVector3D* normals = attribute.normals;
+    const aiVector3D* tangents = static_cast<const aiVector3D*>(attribute.source);
+    const aiVector3D* bitangents = attribute.bitangents;
+    const size_t numSourceVertices = attribute.numSourceVertices;
+    const bool quantized = attribute.components != 0;
+    const assimp_anari_bridge::NormalizedFormat format = attribute.format;
+    std::atomic<float>* error = attribute.error;
+    return [normals, tangents, bitangents, numSourceVertices, chunk, quantized, format, error](void* destination, size_t begin, size_t end) {
+      const uint32_t* vertices = chunk ? chunk->vertices.data() : nullptr;
+      if (!quantized) {
+        assimp_anari_bridge::packTangents(normals, tangents, bitangents, numSourceVertices, vertices, static_cast<float*>(destination) + 4 * begin, begin, end);
+        return;
+      }
+      unsigned char* output = static_cast<unsigned char*>(destination);
+      const size_t outputStride = 4 * assimp_anari_bridge::normalizedSize(format);
+      const size_t blockSize = 256;
+      float block[blockSize * 4];
+      float maxError = 0.0f;
+      for (size_t blockStart = begin; blockStart < end; blockStart += blockSize) {
+        const size_t blockEnd = std::min(end, blockStart + blockSize);
+        assimp_anari_bridge::packTangents(normals, tangents, bitangents, numSourceVertices, vertices, block, blockStart, blockEnd);
+        maxError = std::max(maxError, assimp_anari_bridge::quantizeNormalized(block, output + blockStart * outputStride, (blockEnd - blockStart) * 4, format));
+      }
+      atomicMax(*error, maxError);
+    };
+  }
+
+  // Plain copy of [begin, end) vertices, gathered through the chunk vertex list when given
+  ArrayFill copyFill(const VertexAttribute& attribute, const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk) {
+    const unsigned char* source = static_cast<const unsigned char*>(attribute.source);
+    const size_t elementSize = attribute.elementSize;
+    return [chunk, source, elementSize](void* destination, size_t begin, size_t end) {
+      unsigned char* output = static_cast<unsigned char*>(destination);
+      if (!chunk) {
+        std::memcpy(output + begin * elementSize, source + begin * elementSize, (end - begin) * elementSize);
+        return;
+      }
+      for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+        std::memcpy(output + indexVertex * elementSize, source + size_t(chunk->vertices[indexVertex]) * elementSize, elementSize);
+      }
+    };
+  }
+
+  // Positions relative to the mesh origin (zero unless rebased), gathered through the chunk vertex list when given;
+  // the bounds of each range are grown while it is written
+  ArrayFill pointsFill(const VertexAttribute& attribute, const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk, const RangeBounds& bounds) {
+    const aiVector3D* positions = static_cast<const aiVector3D*>(attribute.source);
+    const aiVector3D origin(attribute.origin[0], attribute.origin[1], attribute.origin[2]);
+    return [positions, origin, chunk, bounds](void* destination, size_t begin, size_t end) {
+      const float offset[3] = { origin.x, origin.y, origin.z };
+      assimp_anari_bridge::Bounds& range = (*bounds)[begin / conversionGrain];
+      assimp_anari_bridge::offsetPoints(positions, chunk ? chunk->vertices.data() : nullptr, offset, static_cast<float*>(destination) + 3 * begin, begin, end,
+                                        range.lower, range.upper);
+    };
+  }
+
+  ArrayFill attributeFill(const VertexAttribute& attribute, const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk, const RangeBounds& bounds) {
+    if (attribute.points) {
+      return pointsFill(attribute, chunk, bounds);
+    }
+    if (attribute.bitangents) {
+      return packedTangentFill(attribute, chunk);
+    }
+    if (attribute.components) {
+      return quantizedFill(attribute, chunk);
+    }
+    return copyFill(attribute, chunk);
+  }
+
+  struct UvSet {
+    unsigned int channel;
+    std::string parameter;
+  };
+
+  // uv sets uploaded, each in the vertex.attribute slot the binding table of the material gives its channel
+  std::vector<UvSet> uvSets(const ConversionContext& context, const aiMesh* mesh) {
+    const AttributeUsage& usage = materialUsage(context, mesh);
+    std::vector<UvSet> sets;
+    for (unsigned int indexUV = 0; indexUV < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++indexUV) {
+      if (mesh->mTextureCoords[indexUV] != nullptr && usage.uvAttributes[indexUV] >= 0) {
+        std::stringstream builder;
+        builder << "vertex.attribute" << usage.uvAttributes[indexUV];
+        sets.push_back({ indexUV, builder.str() });
+      }
+    }
+    return sets;
+  }
+
+  // Bytes per vertex of the attributes left out by the material-driven pruning
+  uint64_t prunedVertexBytes(const ConversionContext& context, const aiMesh* mesh) {
+    const AttributeUsage* usage = usageOf(context, mesh);
+    if (!usage) {
+      return 0;
+    }
+    uint64_t bytes = 0;
+    if (!usage->tangents) {
+      bytes += (mesh->mTangents ? sizeof(aiVector3D) : 0) + (mesh->mBitangents ? sizeof(aiVector3D) : 0);
+    }
+    if (!usage->colors && mesh->mColors[0]) {
+      bytes += sizeof(aiColor4D);
+    }
+    for (unsigned int indexUV = 0; indexUV < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++indexUV) {
+      if (mesh->mTextureCoords[indexUV] != nullptr && usage->uvAttributes[indexUV] < 0) {
+        bytes += 2 * sizeof(float);
+      }
+    }
+    return bytes;
+  }
+
+  // Copy the u,v components of [begin, end) uvw coordinates into a FLOAT32_VEC2 buffer, gathered through the
+  // chunk vertex list when given
+  ArrayFill uvFill(const aiVector3D* uvw, const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk) {
+    return [uvw, chunk](void* destination, size_t begin, size_t end) {
+      float* uvs = static_cast<float*>(destination);
+      for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+        const aiVector3D& source = uvw[chunk ? chunk->vertices[indexVertex] : indexVertex];
+        uvs[2 * indexVertex]     = source[0];
+        uvs[2 * indexVertex + 1] = source[1];
+      }
+    };
+  }
+
+  PreparedArray sceneArray(const std::string& parameter, ANARIDataType type, size_t elementSize, const void* memory, uint64_t count) {
+    PreparedArray array;
+    array.parameter = parameter;
+    array.type = type;
+    array.elementSize = elementSize;
+    array.count = count;
+    array.sceneMemory = memory;
+    return array;
+  }
+
+  PreparedArray convertedArray(const std::string& parameter, ANARIDataType type, size_t elementSize, uint64_t count, ArrayFill fill) {
+    PreparedArray array;
+    array.parameter = parameter;
+    array.type = type;
+    array.elementSize = elementSize;
+    array.count = count;
+    array.fill = std::move(fill);
+    return array;
+  }
+
+  // uv set as FLOAT32_VEC2, or UFIXED16_VEC2 with quantizationBits when every u and v lies in [0, 1] (no tiling):
+  // the quantize pass finds out, values clamped by more than a step make the array fall back to FLOAT32_VEC2
+  PreparedArray uvArray(const ConversionContext& context, const std::string& parameter, const aiVector3D* uvw,
+                        const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk, uint64_t count) {
+    if (context.options.quantizationBits == 0) {
+      return convertedArray(parameter, ANARI_FLOAT32_VEC2, 2 * sizeof(float), count, uvFill(uvw, chunk));
+    }
+    std::shared_ptr<QuantizedFallback> fallback = std::make_shared<QuantizedFallback>();
+    fallback->type = ANARI_FLOAT32_VEC2;
+    fallback->elementSize = 2 * sizeof(float);
+    fallback->fill = uvFill(uvw, chunk);
+    fallback->tolerance = 1.0f / 65535.0f;
+    fallback->reported = &context.quantizationErrors.uv;
+    VertexAttribute uvs = floatAttribute(nullptr, ANARI_UFIXED16_VEC2, 2 * sizeof(uint16_t), uvw);
+    uvs.components = 2;
+    uvs.sourceStride = 3;
+    uvs.format = assimp_anari_bridge::NormalizedFormat::UNORM16;
+    uvs.error = &fallback->error;
+    PreparedArray array = convertedArray(parameter, uvs.type, uvs.elementSize, count, quantizedFill(uvs, chunk));
+    array.fallback = std::move(fallback);
+    return array;
+  }
+
+  // Whether the quantized fill of an array fitted its format; its error is reported when kept
+  bool keepQuantized(QuantizedFallback& fallback) {
+    const float error = fallback.error.load(std::memory_order_relaxed);
+    if (error > fallback.tolerance) {
+      return false;
+    }
+    atomicMax(*fallback.reported, error);
+    return true;
+  }
+
+  // Run the conversion of an array at preparation, unless it is deferred to the mapped device array
+  void stageArray(const ConversionContext& context, PreparedArray& array) {
+    if (!array.fill || context.options.mapDeviceArrays) {
+      return;
+    }
+    if (array.generated) {
+      // already in its upload layout; swapping keeps the buffer address other fills may read from
+      array.staged.swap(*array.generated);
+      return;
+    }
+    array.staged.resize(array.count * array.elementSize);
+    void* destination = array.staged.data();
+    context.pool.parallelForRange(array.count, conversionGrain, [&](size_t begin, size_t end) {
+      array.fill(destination, begin, end);
+    });
+    if (array.fallback && !keepQuantized(*array.fallback)) {
+      array.type = array.fallback->type;
+      array.elementSize = array.fallback->elementSize;
+      array.fill = array.fallback->fill;
+      array.fallback.reset();
+      stageArray(context, array);
+    }
+  }
+
+  // Whole mesh as one geometry: attributes straight from the aiMesh unless quantized, uvs and indices repacked
+  void prepareGeometry(const ConversionContext& context, const aiMesh* mesh, const VertexSources& sources, PreparedGeometry& geometry) {
+    for (const VertexAttribute& attribute: vertexAttributes(context, mesh, sources)) {
+      const RangeBounds bounds = attribute.points ? newRangeBounds(mesh->mNumVertices) : nullptr;
+      if (isConverted(attribute)) {
+        geometry.arrays.push_back(convertedArray(attribute.parameter, attribute.type, attribute.elementSize, mesh->mNumVertices, attributeFill(attribute, nullptr, bounds)));
+        geometry.arrays.back().generated = attribute.generated;
+      } else {
+        geometry.arrays.push_back(sceneArray(attribute.parameter, attribute.type, attribute.elementSize, attribute.source, mesh->mNumVertices));
+        if (bounds) {
+          growRangeBounds(mesh->mVertices, mesh->mNumVertices, context.pool, *bounds);
+        }
+      }
+      geometry.arrays.back().bounds = bounds;
+    }
+
+    for (const UvSet& uvSet: uvSets(context, mesh)) {
+      geometry.arrays.push_back(uvArray(context, uvSet.parameter, mesh->mTextureCoords[uvSet.channel], nullptr, mesh->mNumVertices));
+    }
+
+    if (mesh->mFaces) {
+      const aiFace* faces = mesh->mFaces;
+      geometry.arrays.push_back(convertedArray("primitive.index", ANARI_UINT32_VEC3, 3 * sizeof(uint32_t), mesh->mNumFaces,
+        [faces](void* indices, size_t begin, size_t end) { assimp_anari_bridge::flattenTriangles(faces, static_cast<uint32_t*>(indices), begin, end); }));
+    }
+  }
+
+  // One chunk of a split mesh: every attribute gathered through the chunk vertex list
+  void prepareChunkGeometry(const ConversionContext& context, const aiMesh* mesh, const VertexSources& sources,
+                            const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk, PreparedGeometry& geometry) {
+    const uint64_t numVertices = chunk->vertices.size();
+    for (const VertexAttribute& attribute: vertexAttributes(context, mesh, sources)) {
+      const RangeBounds bounds = attribute.points ? newRangeBounds(numVertices) : nullptr;
+      geometry.arrays.push_back(convertedArray(attribute.parameter, attribute.type, attribute.elementSize, numVertices, attributeFill(attribute, chunk, bounds)));
+      geometry.arrays.back().bounds = bounds;
+    }
+
+    for (const UvSet& uvSet: uvSets(context, mesh)) {
+      geometry.arrays.push_back(uvArray(context, uvSet.parameter, mesh->mTextureCoords[uvSet.channel], chunk, numVertices));
+    }
+
+    geometry.arrays.push_back(convertedArray("primitive.index", ANARI_UINT32_VEC3, 3 * sizeof(uint32_t), chunk->indices.size() / 3,
+      [chunk](void* destination, size_t begin, size_t end) {
+        std::memcpy(static_cast<uint32_t*>(destination) + 3 * begin, chunk->indices.data() + 3 * begin, (end - begin) * 3 * sizeof(uint32_t));
+      }));
+  }
+
+  // Geometries of a chunk: split again when it overflows the device index limit, or only reordered with reorderTriangles
+  void prepareChunkGeometries(const ConversionContext& context, const aiMesh* mesh, const VertexSources& sources,
+                              const std::shared_ptr<const assimp_anari_bridge::MeshChunk>& chunk, std::vector<PreparedGeometry>& geometries) {
+    const bool overflowsIndices = chunk->vertices.size() > context.geometryMaxIndex;
+    if (overflowsIndices || context.options.reorderTriangles) {
+      const uint64_t maxVertices = overflowsIndices ? context.geometryMaxIndex : std::numeric_limits<uint64_t>::max();
+      for (assimp_anari_bridge::MeshChunk& split: assimp_anari_bridge::splitMesh(mesh, maxVertices, context.pool, chunk.get())) {
+        geometries.emplace_back();
+        prepareChunkGeometry(context, mesh, sources, std::make_shared<const assimp_anari_bridge::MeshChunk>(std::move(split)), geometries.back());
+      }
+      return;
+    }
+    geometries.emplace_back();
+    prepareChunkGeometry(context, mesh, sources, chunk, geometries.back());
+  }
+
+  // Size of the arrays of prepared geometries
+  uint64_t preparedBytes(const std::vector<PreparedGeometry>& geometries) {
+    uint64_t bytes = 0;
+    for (const PreparedGeometry& geometry: geometries) {
+      for (const PreparedArray& array: geometry.arrays) {
+        bytes += array.count * array.elementSize;
+      }
+    }
+    return bytes;
+  }
+
+  // Triangles of prepared geometries
+  uint64_t preparedTriangles(const std::vector<PreparedGeometry>& geometries) {
+    uint64_t triangles = 0;
+    for (const PreparedGeometry& geometry: geometries) {
+      triangles += geometry.arrays.back().count;   // primitive.index comes last
+    }
+    return triangles;
+  }
+
+  // Bounds of the uploaded positions of prepared geometries, once their arrays are filled (staged or submitted)
+  assimp_anari_bridge::Bounds preparedBounds(const std::vector<PreparedGeometry>& geometries) {
+    assimp_anari_bridge::Bounds bounds;
+    for (const PreparedGeometry& geometry: geometries) {
+      const PreparedArray& positions = geometry.arrays.front();   // vertex.position comes first
+      if (positions.bounds) {
+        growBounds(bounds, reduceBounds(*positions.bounds));
+      }
+    }
+    return bounds;
+  }
+
+  // Per-vertex arrays a weld must compare: every source of an uploaded attribute
+  std::vector<std::pair<const void*, size_t>> weldStreams(const ConversionContext& context, const aiMesh* mesh, const VertexSources& sources) {
+    std::vector<std::pair<const void*, size_t>> streams;
+    for (const VertexAttribute& attribute: vertexAttributes(context, mesh, sources)) {
+      if (attribute.bitangents) {
+        streams.push_back({ attribute.source, sizeof(aiVector3D) });
+        streams.push_back({ attribute.bitangents, sizeof(aiVector3D) });
+      } else if (attribute.components) {
+        streams.push_back({ attribute.source, attribute.sourceStride * sizeof(float) });
+      } else {
+        streams.push_back({ attribute.source, attribute.elementSize });
+      }
+    }
+    for (const UvSet& uvSet: uvSets(context, mesh)) {
+      streams.push_back({ mesh->mTextureCoords[uvSet.channel], sizeof(aiVector3D) });
+    }
+    return streams;
+  }
+
+  // Pure CPU work, safe to run concurrently for different meshes. Positions are uploaded relative to a non-zero origin.
+  void prepareMesh(const ConversionContext& context, const aiMesh* mesh, const aiVector3D& origin, PreparedMesh& prepared) {
+    prepared.mesh = mesh;
+    prepared.skipped = true;
+
+    if (mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+      // We ignore mesh that are not triangle at the moment
+      return;
+    }
+    prepared.skipped = false;
+
+    VertexSources sources = { mesh->mNormals, mesh->mTangents, mesh->mBitangents };
+    sources.rebased = origin.x != 0.0f || origin.y != 0.0f || origin.z != 0.0f;
+    sources.origin = origin;
+    if (mesh->mNormals == nullptr && mesh->mFaces != nullptr && context.options.generateNormals) {
+      prepared.generatedNormals.resize(size_t(mesh->mNumVertices) * sizeof(aiVector3D));
+      aiVector3D* normals = reinterpret_cast<aiVector3D*>(prepared.generatedNormals.data());
+      assimp_anari_bridge::generateSmoothNormals(mesh, context.options.normalCreaseAngle, context.pool, normals);
+      sources.normals = normals;
+      sources.generatedNormals = &prepared.generatedNormals;
+    }
+    // Tangents only matter for normal mapping: generated for the meshes whose material has a normal map
+    const int normalMapChannel = materialUsage(context, mesh).normalMapChannel;
+    if (mesh->mTangents == nullptr && context.options.generateTangents && sources.normals && mesh->mFaces != nullptr &&
+        normalMapChannel >= 0 && normalMapChannel < AI_MAX_NUMBER_OF_TEXTURECOORDS && mesh->mTextureCoords[normalMapChannel] != nullptr) {
+      prepared.generatedTangents.resize(size_t(mesh->mNumVertices) * 4 * sizeof(float));
+      assimp_anari_bridge::generateTangents(mesh, sources.normals, mesh->mTextureCoords[normalMapChannel], context.pool,
+                                            reinterpret_cast<float*>(prepared.generatedTangents.data()));
+      sources.generatedTangents = &prepared.generatedTangents;
+    }
+
+    // Welding: identical vertices merged, degenerate triangles and unused vertices dropped, as a chunk over the mesh
+    std::shared_ptr<const assimp_anari_bridge::MeshChunk> welded;
+    if (mesh->mFaces != nullptr && context.options.weldVertices) {
+      const auto start = std::chrono::steady_clock::now();
+      welded = std::make_shared<const assimp_anari_bridge::MeshChunk>(assimp_anari_bridge::weldMesh(mesh, weldStreams(context, mesh, sources), context.pool));
+      prepared.weld.verticesBefore = mesh->mNumVertices;
+      prepared.weld.verticesAfter = unsigned(welded->vertices.size());
+      prepared.weld.trianglesBefore = mesh->mNumFaces;
+      prepared.weld.trianglesAfter = unsigned(welded->indices.size() / 3);
+      prepared.weld.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      prepared.welded = true;
+    }
+
+    const uint64_t numVertices = welded ? welded->vertices.size() : mesh->mNumVertices;
+    const uint64_t numTriangles = welded ? welded->indices.size() / 3 : mesh->mNumFaces;
+    const bool overflowsIndices = mesh->mFaces != nullptr && numVertices > context.geometryMaxIndex;
+    if (mesh->mFaces != nullptr && context.options.clusterTriangles > 0 && numTriangles > context.options.clusterTriangles) {
+      // Spatial clusters, each its own geometry; split again (or only reordered) like whole meshes
+      for (assimp_anari_bridge::MeshChunk& cluster: assimp_anari_bridge::clusterMesh(mesh, context.options.clusterTriangles, context.pool, welded.get())) {
+        prepareChunkGeometries(context, mesh, sources, std::make_shared<const assimp_anari_bridge::MeshChunk>(std::move(cluster)), prepared.geometries);
+      }
+    } else if (overflowsIndices || (mesh->mFaces != nullptr && context.options.reorderTriangles)) {
+      // Indices would overflow the device limit: split the mesh in spatially coherent chunks that fit it.
+      // aiMesh vertex counts are 32-bit, so wider index arrays can never help here.
+      // Without vertex budget the same pass only reorders: triangles along the Morton curve and
+      // vertices in first use order, as a single chunk.
+      const uint64_t maxVertices = overflowsIndices ? context.geometryMaxIndex : std::numeric_limits<uint64_t>::max();
+      for (assimp_anari_bridge::MeshChunk& chunk: assimp_anari_bridge::splitMesh(mesh, maxVertices, context.pool, welded.get())) {
+        prepared.geometries.emplace_back();
+        prepareChunkGeometry(context, mesh, sources, std::make_shared<const assimp_anari_bridge::MeshChunk>(std::move(chunk)), prepared.geometries.back());
+      }
+    } else if (welded) {
+      prepared.geometries.emplace_back();
+      prepareChunkGeometry(context, mesh, sources, welded, prepared.geometries.back());
+    } else {
+      prepared.geometries.emplace_back();
+      prepareGeometry(context, mesh, sources, prepared.geometries.back());
+    }
+
+    // Levels of detail: each simplified from the previous one (the welded mesh for the first), until one stops shrinking
+    if (mesh->mFaces != nullptr && context.options.lodLevels > 0) {
+      prepared.lodReports.push_back({ 1, preparedTriangles(prepared.geometries), preparedBytes(prepared.geometries), 0.0 });
+      std::shared_ptr<const assimp_anari_bridge::MeshChunk> previous = welded;
+      uint64_t triangles = numTriangles;
+      for (unsigned int level = 1; level <= context.options.lodLevels; ++level) {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t target = size_t(double(triangles) * context.options.lodReduction);
+        auto lod = std::make_shared<const assimp_anari_bridge::MeshChunk>(assimp_anari_bridge::simplifyMesh(mesh, target, context.pool, previous.get()));
+        if (lod->indices.empty() || lod->indices.size() / 3 >= triangles) {
+          break;
+        }
+        triangles = lod->indices.size() / 3;
+        prepared.lods.emplace_back();
+        prepareChunkGeometries(context, mesh, sources, lod, prepared.lods.back());
+        prepared.lodReports.push_back({ 1, triangles, preparedBytes(prepared.lods.back()),
+                                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() });
+        previous = lod;
+      }
+    }
+
+    uint64_t uploadedVertices = 0;
+    for (PreparedGeometry& geometry: prepared.geometries) {
+      uploadedVertices += geometry.arrays.front().count;   // vertex.position comes first
+    }
+    prepared.prunedBytes = prunedVertexBytes(context, mesh) * uploadedVertices;
+
+    for (PreparedGeometry& geometry: prepared.geometries) {
+      for (PreparedArray& array: geometry.arrays) {
+        stageArray(context, array);
+      }
+    }
+    for (std::vector<PreparedGeometry>& lod: prepared.lods) {
+      for (PreparedGeometry& geometry: lod) {
+        for (PreparedArray& array: geometry.arrays) {
+          stageArray(context, array);
+        }
+      }
+    }
+  }
+
+  // Device-owned array filled in place: created without app memory, mapped, converted in parallel chunks, then unmapped.
+  // Saves the staging buffer and the device copy.
+  ANARIArray1D newMappedArray1D(const ConversionContext& context, ANARIDataType type, uint64_t count, const ArrayFill& fill) {
+    ANARIArray1D array = anariNewArray1D(context.device, nullptr, 0, 0, type, count);
+    void* destination = anariMapArray(context.device, array);
+    context.pool.parallelForRange(count, conversionGrain, [&](size_t begin, size_t end) {
+      fill(destination, begin, end);
+    });
+    anariUnmapArray(context.device, array);
+    return array;
+  }
+
+  // Mapped array of a prepared array, created again with its fallback conversion when the quantized one did not fit
+  ANARIArray1D newMappedArray1D(const ConversionContext& context, const PreparedArray& prepared) {
+    ANARIArray1D array = newMappedArray1D(context, prepared.type, prepared.count, prepared.fill);
+    if (prepared.fallback && !keepQuantized(*prepared.fallback)) {
+      anariRelease(context.device, array);
+      array = newMappedArray1D(context, prepared.fallback->type, prepared.count, prepared.fallback->fill);
+    }
+    return array;
+  }
+
+  ANARIArray1D submitArray(const ConversionContext& context, const PreparedArray& prepared) {
+    if (prepared.sceneMemory) {
+      return newSceneArray1D(context.device, context.owner, prepared.sceneMemory, prepared.type, prepared.count);
+    }
+    if (context.options.mapDeviceArrays) {
+      return newMappedArray1D(context, prepared);
+    }
+    return anariNewArray1D(context.device, prepared.staged.data(), 0, 0, prepared.type, prepared.count);
+  }
+
+  // Create and commit the geometries of prepared arrays
+  std::vector<ANARIGeometry> submitGeometries(const ConversionContext& context, size_t index, const std::vector<PreparedGeometry>& preparedGeometries) {
+    ANARIDevice device = context.device;
+    std::vector<ANARIGeometry> geometries;
+    for (const PreparedGeometry& preparedGeometry: preparedGeometries) {
+      std::cerr << "create geometry associated with mesh = " << index << std::endl;
+
+      ANARIGeometry geometry = anariNewGeometry(device, "triangle");
+
+      for (const PreparedArray& preparedArray: preparedGeometry.arrays) {
+        std::cerr << "create " << preparedArray.parameter << " = " << preparedArray.count << std::endl;
+        ANARIArray1D array = submitArray(context, preparedArray);
+        anariCommitParameters(device, array);
+        anariSetParameter(device, geometry, preparedArray.parameter.c_str(), ANARI_ARRAY1D, &array);
+        anariRelease(device, array); // we are done using this handle
+      }
+      std::cerr<< "after all" << std::endl;
+
+      anariCommitParameters(device, geometry);
+      geometries.push_back(geometry);
+    }
+    return geometries;
+  }
+
+  // Device side of the conversion, must be called from a single thread
+  std::vector<ANARIGeometry> submitMesh(const ConversionContext& context, size_t index, const PreparedMesh& prepared) {
+    if (prepared.geometries.size() > 1) {
+      std::cerr << "split mesh = " << index << " in " << prepared.geometries.size() << " geometries"
+                << (context.options.clusterTriangles ? " (clusterTriangles, geometryMaxIndex)" : " (geometryMaxIndex)") << std::endl;
+    }
+    return submitGeometries(context, index, prepared.geometries);
+  }
+
+  // For each mesh, the first mesh with the same content (itself when unique).
+  // Content hashes are computed in parallel, equal hashes are confirmed by comparing the data.
+  std::vector<unsigned int> findDuplicateMeshes(const aiScene* scene, assimp_anari_bridge::ThreadPool& pool) {
+    std::vector<unsigned int> firstOccurrence(scene->mNumMeshes);
+    std::vector<uint64_t> hashes(scene->mNumMeshes);
+    pool.parallelFor(scene->mNumMeshes, [&](size_t index) {
+      firstOccurrence[index] = unsigned(index);
+      const aiMesh* mesh = scene->mMeshes[index];
+      if (mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE) {
+        hashes[index] = assimp_anari_bridge::meshContentHash(mesh);
+      }
+    });
+
+    std::map<uint64_t, std::vector<unsigned int>> meshesByHash;
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      if (scene->mMeshes[index]->mPrimitiveTypes == aiPrimitiveType_TRIANGLE) {
+        meshesByHash[hashes[index]].push_back(index);
+      }
+    }
+
+    pool.parallelFor(scene->mNumMeshes, [&](size_t index) {
+      const aiMesh* mesh = scene->mMeshes[index];
+      if (mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+        return;
+      }
+      for (unsigned int candidate: meshesByHash.find(hashes[index])->second) {
+        if (candidate >= index) {
+          break;
+        }
+        if (assimp_anari_bridge::meshesHaveSameContent(scene->mMeshes[candidate], mesh)) {
+          firstOccurrence[index] = candidate;
+          break;
+        }
+      }
+    });
+    return firstOccurrence;
+  }
+
+  // Meshes that are transformed copies of an earlier mesh: geometrySource and meshTransforms are updated
+  // so that the copy uses the geometry of its reference mesh, placed by the transform.
+  // Candidates are grouped by topology hash and the groups are analysed in parallel.
+  void findRigidCopies(const aiScene* scene, assimp_anari_bridge::ThreadPool& pool, float tolerance,
+                       std::vector<unsigned int>& geometrySource, std::vector<aiMatrix4x4>& meshTransforms) {
+    // References tried per candidate, bounds the cost of groups with many distinct shapes
+    const size_t maxReferences = 16;
+
+    std::vector<uint64_t> hashes(scene->mNumMeshes);
+    pool.parallelFor(scene->mNumMeshes, [&](size_t index) {
+      const aiMesh* mesh = scene->mMeshes[index];
+      if (geometrySource[index] == index && mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE) {
+        hashes[index] = assimp_anari_bridge::meshTopologyHash(mesh);
+      }
+    });
+
+    std::map<uint64_t, std::vector<unsigned int>> meshesByHash;
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      if (geometrySource[index] == index && scene->mMeshes[index]->mPrimitiveTypes == aiPrimitiveType_TRIANGLE) {
+        meshesByHash[hashes[index]].push_back(index);
+      }
+    }
+    std::vector<const std::vector<unsigned int>*> candidates;
+    for (const auto& pair: meshesByHash) {
+      if (pair.second.size() > 1) {
+        candidates.push_back(&pair.second);
+      }
+    }
+
+    pool.parallelFor(candidates.size(), [&](size_t group) {
+      std::vector<unsigned int> references;
+      for (unsigned int index: *candidates[group]) {
+        bool found = false;
+        for (unsigned int reference: references) {
+          aiMatrix4x4 transform;
+          if (assimp_anari_bridge::findSimilarityTransform(scene->mMeshes[reference], scene->mMeshes[index], tolerance, transform)) {
+            geometrySource[index] = reference;
+            meshTransforms[index] = transform;
+            found = true;
+            break;
+          }
+        }
+        if (!found && references.size() < maxReferences) {
+          references.push_back(index);
+        }
+      }
+    });
+  }
 
-      void* pImageData = stbi_load_from_memory((const stbi_uc*)aiTexture->pcData, aiTexture->mWidth, &imageWidth, &imageHeight, &imageBPP, 0);
-      anariSetParameter(device, sampler, "image", ANARI_ARRAY2D, pImageData);
-      anariSetParameter(device, sampler, "inAttribute", ANARI_STRING, "attribute0");
-      anariSetParameter(device, sampler, "filter", ANARI_STRING, "linear");
-      anariSetParameter(device, sampler, "wrapMode1", ANARI_STRING, "repeat");
-      anariSetParameter(device, sampler, "wrapMode2", ANARI_STRING, "repeat");
+  // Array of object handles, written through a mapped array so that the device holds its own references
+  ANARIArray1D newObjectArray1D(ANARIDevice device, ANARIDataType type, const std::vector<ANARIObject>& objects) {
+    ANARIArray1D array = anariNewArray1D(device, nullptr, 0, 0, type, objects.size());
+    std::memcpy(anariMapArray(device, array), objects.data(), objects.size() * sizeof(ANARIObject));
+    anariUnmapArray(device, array);
+    return array;
+  }
 
-      anariCommitParameters(device, sampler);
-      stbi_image_free(pImageData);
-      std::cerr<<"loaded image texture dims : "<<imageWidth<<","<<imageHeight<<" bits per pixel : "<<imageBPP<<std::endl;
-      return true;
+  // One surface per geometry of a mesh, gathered in the group shared by every placement of the mesh
+  ANARIGroup submitGroup(ANARIDevice device, const std::vector<ANARIGeometry>& geometries, ANARIMaterial material, std::vector<ANARISurface>& surfaces) {
+    std::vector<ANARIObject> groupSurfaces;
+    for (ANARIGeometry geometry: geometries) {
+      ANARISurface surface = anariNewSurface(device);
+      anariSetParameter(device, surface, "geometry", ANARI_GEOMETRY, &geometry);
+      anariSetParameter(device, surface, "material", ANARI_MATERIAL, &material);
+      anariCommitParameters(device, surface);
+      surfaces.push_back(surface);
+      groupSurfaces.push_back(surface);
     }
+    ANARIGroup group = anariNewGroup(device);
+    ANARIArray1D array = newObjectArray1D(device, ANARI_SURFACE, groupSurfaces);
+    anariSetParameter(device, group, "surface", ANARI_ARRAY1D, &array);
+    anariRelease(device, array); // we are done using this handle
+    anariCommitParameters(device, group);
+    return group;
   }
-  return false;
-}
 
-// Use C++99
-ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device) {
-  // check if device supports quad, triangle (KHR_GEOMETRY_QUAD, KHR_GEOMETRY_TRIANGLE)
-  ANARIWorld world = anariNewWorld(device);
+  // A mesh referenced by a node, with the transform accumulated from the root
+  struct MeshPlacement {
+    unsigned int meshIndex;
+    aiMatrix4x4 transform;
+    const aiNode* node = nullptr;   // nullptr without node hierarchy
+    bool animated = false;          // an animation channel drives the node or one of its ancestors
+  };
 
-  std::map<unsigned int, ANARIGeometry> geometriesByMeshId;
-  std::map<unsigned int, ANARIMaterial> materialsByMaterialId;
-  std::map<unsigned int, ANARISurface> surfacesByMeshId;
-  std::map<unsigned int, ANARIInstance> instancesByNodeId;
-  std::map<unsigned int, ANARIGroup> groupsByNodeId;
+  // Depth first walk of the node hierarchy, in node order
+  std::vector<MeshPlacement> collectPlacements(const aiScene* scene) {
+    std::vector<MeshPlacement> placements;
+    if (scene->mRootNode == nullptr) {
+      // No hierarchy: every mesh is placed once, untransformed
+      for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+        placements.push_back({ index, aiMatrix4x4() });
+      }
+      return placements;
+    }
+    // Animation channels target nodes by name
+    std::set<std::string> animatedNodes;
+    for (unsigned int animation = 0; animation < scene->mNumAnimations; ++animation) {
+      for (unsigned int channel = 0; channel < scene->mAnimations[animation]->mNumChannels; ++channel) {
+        animatedNodes.insert(scene->mAnimations[animation]->mChannels[channel]->mNodeName.C_Str());
+      }
+    }
+    struct Visit {
+      const aiNode* node;
+      aiMatrix4x4 transform;
+      bool animated;
+    };
+    std::vector<Visit> stack;
+    stack.push_back({ scene->mRootNode, scene->mRootNode->mTransformation, animatedNodes.count(scene->mRootNode->mName.C_Str()) > 0 });
+    while (!stack.empty()) {
+      const Visit visit = stack.back();
+      stack.pop_back();
+      for (unsigned int index = 0; index < visit.node->mNumMeshes; ++index) {
+        placements.push_back({ visit.node->mMeshes[index], visit.transform, visit.node, visit.animated });
+      }
+      for (unsigned int index = visit.node->mNumChildren; index > 0; --index) {
+        const aiNode* child = visit.node->mChildren[index - 1];
+        stack.push_back({ child, visit.transform * child->mTransformation, visit.animated || animatedNodes.count(child->mName.C_Str()) > 0 });
+      }
+    }
+    return placements;
+  }
 
-  // Limits
-  uint64_t geometryMaxIndex = 0;
 
-  std::cerr << "getProperty = " << geometryMaxIndex << std::endl;
-  if (anariGetProperty(device, device, "geometryMaxIndex", ANARI_UINT64, &geometryMaxIndex, sizeof(uint64_t), ANARI_WAIT)) {
-    std::cerr << "geometryMaxIndex = " << geometryMaxIndex << std::endl;
-  } else {
-    geometryMaxIndex = std::numeric_limits<uint32_t>::max();
-    std::cerr << "geometryMaxIndex (not returned) = " << geometryMaxIndex << std::endl;
+  aiVector3D boundsCenter(const assimp_anari_bridge::Bounds& bounds) {
+    return aiVector3D(0.5f * (bounds.lower[0] + bounds.upper[0]), 0.5f * (bounds.lower[1] + bounds.upper[1]), 0.5f * (bounds.lower[2] + bounds.upper[2]));
+  }
+
+  // Box containing the transformed corners of a box
+  assimp_anari_bridge::Bounds transformBounds(const assimp_anari_bridge::Bounds& bounds, const aiMatrix4x4& transform) {
+    assimp_anari_bridge::Bounds transformed;
+    if (bounds.empty()) {
+      return transformed;
+    }
+    for (unsigned int corner = 0; corner < 8; ++corner) {
+      const aiVector3D point = transform * aiVector3D((corner & 1) ? bounds.upper[0] : bounds.lower[0],
+                                                      (corner & 2) ? bounds.upper[1] : bounds.lower[1],
+                                                      (corner & 4) ? bounds.upper[2] : bounds.lower[2]);
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        transformed.lower[axis] = std::min(transformed.lower[axis], point[axis]);
+        transformed.upper[axis] = std::max(transformed.upper[axis], point[axis]);
+      }
+    }
+    return transformed;
   }
 
+  // Small static placements baked together by mergeSmallMeshes
+  struct MergedMesh {
+    std::unique_ptr<aiMesh> mesh;
+    std::vector<size_t> placements;   // merged placements, in triangle order
+    assimp_anari_bridge::Bounds bounds;   // world space, as the merged vertices, from the fill of the positions
+  };
 
-  if (scene->HasMeshes()) {
-    for (size_t index = 0; index < scene->mNumMeshes; ++index) {
-      std::cerr << "mesh = " << (index + 1) << "/" << scene->mNumMeshes << std::endl;
+  // Merged meshes and the scene they come from, kept alive by the arrays sharing their memory
+  struct MergedScene {
+    SceneOwner scene;
+    std::vector<MergedMesh> meshes;
+  };
 
-      const aiMesh* mesh = scene->mMeshes[index];
-      mesh->mPrimitiveTypes;//aiPrimitiveType
-      if (mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
-        // We ignore mesh that are not triangle at the moment
-        continue;
+  // Attribute arrays of a mesh as a bit set: only meshes with the same arrays are merged together
+  uint32_t attributeLayout(const aiMesh* mesh) {
+    uint32_t layout = (mesh->mNormals ? 1u : 0u) | (mesh->mTangents ? 2u : 0u) | (mesh->mBitangents ? 4u : 0u) | (mesh->mColors[0] ? 8u : 0u);
+    for (unsigned int channel = 0; channel < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++channel) {
+      if (mesh->mTextureCoords[channel]) {
+        layout |= (16u << channel);
       }
+    }
+    return layout;
+  }
 
-      if (mesh->mFaces != nullptr && mesh->mNumVertices > geometryMaxIndex) {
-        // We ignore mesh with a number of vertices superior to device limit if we have index-based mesh
+  // Group the small static placements by material, attribute layout and grid cell of their center,
+  // then bake each group (within the device vertex limit) into one world space mesh.
+  // The bounds of the candidate meshes are computed here, ahead of their conversion.
+  std::vector<MergedMesh> mergePlacements(const ConversionContext& context, const aiScene* scene, const std::vector<MeshPlacement>& placements,
+                                          std::vector<assimp_anari_bridge::Bounds>& meshBounds) {
+    const assimp_anari_bridge::BridgeOptions& options = context.options;
+    std::vector<size_t> candidates;
+    for (size_t index = 0; index < placements.size(); ++index) {
+      const MeshPlacement& placement = placements[index];
+      if (placement.animated || placement.meshIndex >= scene->mNumMeshes) {
         continue;
       }
+      const aiMesh* mesh = scene->mMeshes[placement.meshIndex];
+      // skinned and morphed meshes are deformed in their own space, never baked
+      if (mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE && mesh->mFaces != nullptr && mesh->mNumFaces > 0 &&
+          mesh->mNumFaces <= options.mergeTriangleThreshold && mesh->mNumBones == 0 && mesh->mNumAnimMeshes == 0) {
+        candidates.push_back(index);
+      }
+    }
 
-      std::cerr << "create geometry associated with mesh = " << index << std::endl;
+    std::vector<unsigned int> candidateMeshes;
+    for (size_t candidate: candidates) {
+      candidateMeshes.push_back(placements[candidate].meshIndex);
+    }
+    std::sort(candidateMeshes.begin(), candidateMeshes.end());
+    candidateMeshes.erase(std::unique(candidateMeshes.begin(), candidateMeshes.end()), candidateMeshes.end());
+    context.pool.parallelFor(candidateMeshes.size(), [&](size_t index) {
+      const aiMesh* mesh = scene->mMeshes[candidateMeshes[index]];
+      meshBounds[candidateMeshes[index]] = pointBounds(mesh->mVertices, mesh->mNumVertices, context.pool);
+    });
 
-      ANARIGeometry geometry = anariNewGeometry(device, "triangle");
+    // World space center of the bounding box of each candidate
+    std::vector<aiVector3D> centers(candidates.size());
+    for (size_t candidate = 0; candidate < candidates.size(); ++candidate) {
+      const MeshPlacement& placement = placements[candidates[candidate]];
+      centers[candidate] = placement.transform * boundsCenter(meshBounds[placement.meshIndex]);
+    }
+    aiVector3D lower(std::numeric_limits<float>::max()), upper(-std::numeric_limits<float>::max());
+    for (const aiVector3D& center: centers) {
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        lower[axis] = std::min(lower[axis], center[axis]);
+        upper[axis] = std::max(upper[axis], center[axis]);
+      }
+    }
 
-      ANARIArray1D array;
+    // Groups in (material, layout, cell) order, placements in node order within a group
+    const unsigned int resolution = std::max(1u, options.mergeGridResolution);
+    std::map<std::tuple<unsigned int, uint32_t, uint64_t>, std::vector<size_t>> groups;
+    for (size_t candidate = 0; candidate < candidates.size(); ++candidate) {
+      const aiMesh* mesh = scene->mMeshes[placements[candidates[candidate]].meshIndex];
+      uint64_t cell = 0;
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        const float extent = upper[axis] - lower[axis];
+        const unsigned int coordinate = extent > 0.0f ? std::min(resolution - 1, unsigned((centers[candidate][axis] - lower[axis]) / extent * resolution)) : 0;
+        cell = cell * resolution + coordinate;
+      }
+      groups[std::make_tuple(mesh->mMaterialIndex, attributeLayout(mesh), cell)].push_back(candidates[candidate]);
+    }
 
-      std::cerr << "create vertices = " << mesh->mNumVertices << std::endl;
-      array = anariNewArray1D(device, (float*)mesh->mVertices, 0, 0, ANARI_FLOAT32_VEC3, mesh->mNumVertices);
-      anariCommitParameters(device, array);
-      anariSetParameter(device, geometry, "vertex.position", ANARI_ARRAY1D, &array);
-      anariRelease(device, array); // we are done using this handle
+    std::vector<MergedMesh> merged;
+    const uint64_t maxVertices = std::min<uint64_t>(context.geometryMaxIndex, std::numeric_limits<uint32_t>::max());
+    for (const auto& group: groups) {
+      std::vector<std::vector<size_t>> parts(1);
+      uint64_t numVertices = 0;
+      for (size_t placement: group.second) {
+        const unsigned int meshVertices = scene->mMeshes[placements[placement].meshIndex]->mNumVertices;
+        if (!parts.back().empty() && numVertices + meshVertices > maxVertices) {
+          parts.emplace_back();
+          numVertices = 0;
+        }
+        parts.back().push_back(placement);
+        numVertices += meshVertices;
+      }
+      for (std::vector<size_t>& part: parts) {
+        // a lone placement gains nothing from being baked
+        if (part.size() > 1) {
+          merged.emplace_back();
+          merged.back().placements = std::move(part);
+        }
+      }
+    }
 
-      if (mesh->mNormals) {
-        std::cerr << "create normals = " << mesh->mNumVertices << std::endl;
-        array = anariNewArray1D(device, (float*)mesh->mNormals, 0, 0, ANARI_FLOAT32_VEC3, mesh->mNumVertices);
-        anariCommitParameters(device, array);
-        anariSetParameter(device, geometry, "vertex.normal", ANARI_ARRAY1D, &array);
-        anariRelease(device, array); // we are done using this handle
+    context.pool.parallelFor(merged.size(), [&](size_t index) {
+      std::vector<assimp_anari_bridge::PlacedMesh> parts;
+      for (size_t placement: merged[index].placements) {
+        parts.push_back({ scene->mMeshes[placements[placement].meshIndex], placements[placement].transform });
       }
+      merged[index].mesh = assimp_anari_bridge::mergePlacedMeshes(parts, context.pool);
+    });
+    return merged;
+  }
 
-      if (mesh->mTangents) {
-        std::cerr << "create tangents = " << mesh->mNumVertices << std::endl;
-        array = anariNewArray1D(device, (float*)mesh->mTangents, 0, 0, ANARI_FLOAT32_VEC3, mesh->mNumVertices);
-        anariCommitParameters(device, array);
-        anariSetParameter(device, geometry, "vertex.tangent", ANARI_ARRAY1D, &array);
-        anariRelease(device, array); // we are done using this handle
+  // ANARI matrices are column major, aiMatrix4x4 is row major
+  void toAnariMatrix(const aiMatrix4x4& matrix, float* transform) {
+    for (unsigned int row = 0; row < 4; ++row) {
+      for (unsigned int column = 0; column < 4; ++column) {
+        transform[4 * column + row] = matrix[row][column];
       }
+    }
+  }
 
-      // TODO should be given in selected attribute / deactivate / or handeness pushed in tangents
-      if (mesh->mBitangents) {
-        std::cerr << "create bitangents = " << mesh->mNumVertices << std::endl;
-        array = anariNewArray1D(device, (float*)mesh->mBitangents, 0, 0, ANARI_FLOAT32_VEC3, mesh->mNumVertices);
-        anariCommitParameters(device, array);
-        anariSetParameter(device, geometry, "vertex.attribute0", ANARI_ARRAY1D, &array);
-        anariRelease(device, array); // we are done using this handle
+  // World space bounding sphere of a placed mesh: center and half diagonal of its box, scaled by the largest axis scale
+  void boundingSphere(const assimp_anari_bridge::Bounds& bounds, const aiMatrix4x4& transform, float* center, float& radius) {
+    const aiVector3D lower(bounds.lower[0], bounds.lower[1], bounds.lower[2]), upper(bounds.upper[0], bounds.upper[1], bounds.upper[2]);
+    const aiVector3D worldCenter = transform * boundsCenter(bounds);
+    float scale = 0.0f;
+    for (unsigned int column = 0; column < 3; ++column) {
+      scale = std::max(scale, aiVector3D(transform[0][column], transform[1][column], transform[2][column]).Length());
+    }
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      center[axis] = worldCenter[axis];
+    }
+    radius = bounds.empty() ? 0.0f : 0.5f * (upper - lower).Length() * scale;
+  }
+
+  ANARIInstance submitInstance(ANARIDevice device, ANARIGroup group, const aiMatrix4x4& matrix) {
+    ANARIInstance instance = anariNewInstance(device, "transform");
+    float transform[16];
+    toAnariMatrix(matrix, transform);
+    anariSetParameter(device, instance, "group", ANARI_GROUP, &group);
+    anariSetParameter(device, instance, "transform", ANARI_FLOAT32_MAT4, transform);
+    anariCommitParameters(device, instance);
+    return instance;
+  }
+
+  // Column-major double precision transform of an instance: matrix, with the mesh origin added back to its translation
+  void rebasedTransform(const aiMatrix4x4& matrix, const aiVector3D& origin, double* transform) {
+    for (unsigned int row = 0; row < 4; ++row) {
+      for (unsigned int column = 0; column < 4; ++column) {
+        transform[4 * column + row] = matrix[row][column];
       }
+    }
+    for (unsigned int row = 0; row < 3; ++row) {
+      transform[12 + row] += double(matrix[row][0]) * origin.x + double(matrix[row][1]) * origin.y + double(matrix[row][2]) * origin.z;
+    }
+  }
 
-      // TODO should be given in selected attribute / deactivate /
-      if (mesh->mColors[0]) {
-        std::cerr << "create colors  = " << mesh->mNumVertices << std::endl;
-        array = anariNewArray1D(device, (float*)mesh->mColors[0], 0, 0, ANARI_FLOAT32_VEC4, mesh->mNumVertices);
-        anariCommitParameters(device, array);
-        anariSetParameter(device, geometry, "vertex.color", ANARI_ARRAY1D, &array);
-        anariRelease(device, array); // we are done using this handle
+  // Single precision transform of a rebasedTransform() relative to the scene origin, only rounded once
+  aiMatrix4x4 relativeTransform(const double* transform, const double* sceneOrigin) {
+    aiMatrix4x4 matrix;
+    for (unsigned int row = 0; row < 4; ++row) {
+      for (unsigned int column = 0; column < 4; ++column) {
+        matrix[row][column] = float(transform[4 * column + row] - (column == 3 && row < 3 ? sceneOrigin[row] : 0.0));
       }
+    }
+    return matrix;
+  }
 
-      int addedUvs = 0;
-      for (unsigned int indexUV = 0; indexUV < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++indexUV) {
-        if (mesh->mTextureCoords[indexUV] == nullptr) {
-          continue;
-        }
-        std::cerr << "create uvs  = " << indexUV << std::endl;
-        if (addedUvs >= 3) {
-          break;
-        }
-        std::vector<float> uvs(mesh->mNumVertices * 2);
-        for (unsigned int indexVertex = 0; indexVertex < mesh->mNumVertices; ++indexVertex) {
-          uvs[2 * indexVertex]     = mesh->mTextureCoords[indexUV][indexVertex][0];
-          uvs[2 * indexVertex + 1] = mesh->mTextureCoords[indexUV][indexVertex][1];
-        }
-        std::stringstream builder;
-        builder << "vertex.attribute" << (1 + addedUvs);
-        std::string text = builder.str();
-        std::cerr << "create uvs  = " << indexUV << " in " << text << std::endl;
-        array = anariNewArray1D(device, uvs.data(), 0, 0, ANARI_FLOAT32_VEC2, mesh->mNumVertices);
-        anariCommitParameters(device, array);
-        anariSetParameter(device, geometry, text.c_str(), ANARI_ARRAY1D, &array);
-        anariRelease(device, array); // we are done using this handle
-        addedUvs++;
+  // Bounds of points once origin is subtracted from them
+  assimp_anari_bridge::Bounds offsetBounds(const assimp_anari_bridge::Bounds& bounds, const aiVector3D& origin) {
+    assimp_anari_bridge::Bounds offset = bounds;
+    if (!bounds.empty()) {
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        offset.lower[axis] -= origin[axis];
+        offset.upper[axis] -= origin[axis];
       }
+    }
+    return offset;
+  }
 
-      mesh->mTextureCoordsNames;//aiString**
-      mesh->mNumUVComponents;//uint[AI_MAX_NUMBER_OF_TEXTURECOORDS]
+}
 
-      if (mesh->mFaces) {
-        std::vector<uint32_t> faces(mesh->mNumFaces * 3);
-        std::cerr << "create faces  = " << mesh->mNumFaces << std::endl;
-        for (unsigned int indexFace = 0; indexFace < mesh->mNumFaces; ++indexFace) {
-          faces[3 * indexFace]     = mesh->mFaces[indexFace].mIndices[0];
-          faces[3 * indexFace + 1] = mesh->mFaces[indexFace].mIndices[1];
-          faces[3 * indexFace + 2] = mesh->mFaces[indexFace].mIndices[2];
-        }
-        array = anariNewArray1D(device, faces.data(), 0, 0, ANARI_UINT32_VEC3, mesh->mNumFaces);
-        anariCommitParameters(device, array);
-        anariSetParameter(device, geometry, "primitive.index", ANARI_ARRAY1D, &array);
-        anariRelease(device, array); // we are done using this handle
-      }
-      std::cerr<< "after all" << std::endl;
+static ANARIWorld bridgeScene(const aiScene* scene, const SceneOwner& owner, ANARIDevice device, const assimp_anari_bridge::BridgeOptions& options, assimp_anari_bridge::BridgeReport* report);
+
+ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device) {
+  return bridgeScene(scene, SceneOwner(), device, BridgeOptions(), nullptr);
+}
 
-      mesh->mName;//aiString
+ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device, const BridgeOptions& options, BridgeReport* report) {
+  return bridgeScene(scene, SceneOwner(), device, options, report);
+}
 
-      mesh->mMaterialIndex;//uint
+ANARIWorld assimp_anari_bridge::bridge(std::shared_ptr<const aiScene> scene, ANARIDevice device, const BridgeOptions& options, BridgeReport* report) {
+  return bridgeScene(scene.get(), scene, device, options, report);
+}
 
-      mesh->mBones;//aiBone**
+static ANARIWorld bridgeScene(const aiScene* scene, const SceneOwner& owner, ANARIDevice device, const assimp_anari_bridge::BridgeOptions& options, assimp_anari_bridge::BridgeReport* report) {
+  using namespace assimp_anari_bridge;
+  BridgeReport localReport;
+  if (report == nullptr) {
+    report = &localReport;
+  }
+  *report = BridgeReport();
+  // check if device supports quad, triangle (KHR_GEOMETRY_QUAD, KHR_GEOMETRY_TRIANGLE)
+  ANARIWorld world = anariNewWorld(device);
+  ThreadPool pool(options.threadCount);
 
-      mesh->mNumBones;//uint
+  std::map<unsigned int, std::vector<ANARIGeometry>> geometriesByMeshId;
+  std::map<unsigned int, ANARIMaterial> materialsByMaterialId;
+  std::map<unsigned int, std::vector<ANARISurface>> surfacesByMeshId;
+  std::map<unsigned int, ANARIGroup> groupsByMeshId;
+  std::map<unsigned int, std::vector<std::vector<ANARIGeometry>>> lodGeometriesByMeshId;   // per level of detail
+  std::map<unsigned int, std::vector<ANARIGroup>> lodGroupsByMeshId;
+  ANARIMaterial defaultMaterial = nullptr;
 
-      mesh->mNumAnimMeshes;//uint
+  // Limits
+  uint64_t geometryMaxIndex = 0;
 
-      mesh->mAnimMeshes;//aiAnimMesh** mAnimMeshes;
+  std::cerr << "getProperty = " << geometryMaxIndex << std::endl;
+  if (anariGetProperty(device, device, "geometryMaxIndex", ANARI_UINT64, &geometryMaxIndex, sizeof(uint64_t), ANARI_WAIT)) {
+    std::cerr << "geometryMaxIndex = " << geometryMaxIndex << std::endl;
+  } else {
+    geometryMaxIndex = std::numeric_limits<uint32_t>::max();
+    std::cerr << "geometryMaxIndex (not returned) = " << geometryMaxIndex << std::endl;
+  }
 
-      mesh->mMethod;//aiMorphingMethod associated to aiANimMesh
 
-      anariCommitParameters(device, geometry);
-      geometriesByMeshId[index] = geometry;
-    }
+  QuantizationErrors quantizationErrors;
+  std::vector<AttributeUsage> attributeUsage;
+  for (unsigned int index = 0; index < scene->mNumMaterials; ++index) {
+    attributeUsage.push_back(materialAttributeUsage(scene->mMaterials[index], options));
   }
+  const ConversionContext context = { device, owner, pool, options, geometryMaxIndex, quantizationErrors, attributeUsage };
 
+  // Every texture is decoded up front on the pool, then samplers reading the same image share its array
+  TextureCache textures;
+  textures.directory = options.textureDirectory;
+  textures.mapFiles = options.mapTextureFiles;
+  textures.mapArrays = options.mapDeviceArrays;
+  collectTextures(scene, options.splitPackedChannels, textures);
+  decodeImages(pool, textures);
   if (scene->HasMaterials()) {
     for (unsigned int index = 0; index < scene->mNumMaterials; ++index) {
 
@@ -204,7 +1736,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
         // Assuming every textures are embedded in the scene
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_BASE_COLOR, 0, sampler))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_BASE_COLOR, 0, sampler, colorView))
           anariSetParameter(device, material, "baseColor", ANARI_SAMPLER, sampler);
         anariRelease(device, sampler);
       }
@@ -228,9 +1760,12 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       if(aiMaterial->GetTextureCount(aiTextureType_DIFFUSE_ROUGHNESS) > 0)
       {
         
+        // With splitPackedChannels each sampler reads its own single channel image instead of a swizzled RGBA one
+        const ImageView metallicView = samplerView(aiTextureType_DIFFUSE_ROUGHNESS, true, options.splitPackedChannels);
+        const ImageView roughnessView = samplerView(aiTextureType_DIFFUSE_ROUGHNESS, false, options.splitPackedChannels);
         ANARISampler metallic = anariNewSampler(device, "image2D");
         // Assuming every textures are embedded in the scene
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_DIFFUSE_ROUGHNESS, 0, metallic))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_DIFFUSE_ROUGHNESS, 0, metallic, metallicView) && metallicView == dataView)
         {
           //According to gltf spec, metallness is encoded in blue channel
           float swizzle[16] = {
@@ -243,7 +1778,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
         }
         ANARISampler roughness = anariNewSampler(device, "image2D");
         // Assuming every textures are embedded in the scene
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_DIFFUSE_ROUGHNESS, 0, roughness))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_DIFFUSE_ROUGHNESS, 0, roughness, roughnessView) && roughnessView == dataView)
         {
           //According to gltf spec, roughness is encoded in green channel
           float swizzle[16] = {
@@ -288,7 +1823,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
         // Assuming every textures are embedded in the scene
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_NORMALS, 0, sampler))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_NORMALS, 0, sampler, dataView))
           anariSetParameter(device, material, "normals", ANARI_SAMPLER, sampler);
         anariRelease(device, sampler);
       }
@@ -309,7 +1844,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
         // Assuming every textures are embedded in the scene
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_EMISSIVE, 0, sampler))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_EMISSIVE, 0, sampler, colorView))
         {
           if(aiMaterial->Get(AI_MATKEY_EMISSIVE_INTENSITY, emissive) == AI_SUCCESS)
           {
@@ -339,7 +1874,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
             anariSetParameter(device, sampler, "inTransform", ANARI_FLOAT32_MAT4, transform);
           }
           anariCommitParameters(device, sampler);
-          anariSetParameter(device, material, "normals", ANARI_SAMPLER, sampler);
+          anariSetParameter(device, material, "emissive", ANARI_SAMPLER, sampler);
         }
         anariRelease(device, sampler);
       }else if(aiMaterial->Get(AI_MATKEY_EMISSIVE_INTENSITY, emissive) == AI_SUCCESS)
@@ -352,7 +1887,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       if(aiMaterial->GetTextureCount(aiTextureType_AMBIENT_OCCLUSION) > 0)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_AMBIENT_OCCLUSION, 0, sampler))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_AMBIENT_OCCLUSION, 0, sampler, samplerView(aiTextureType_AMBIENT_OCCLUSION, false, options.splitPackedChannels)))
           anariSetParameter(device, material, "occlusion", ANARI_SAMPLER, sampler);
         anariRelease(device, sampler);
       }
@@ -381,7 +1916,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       if(aiMaterial->GetTextureCount(aiTextureType_SPECULAR) > 0)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_SPECULAR, 0, sampler))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_SPECULAR, 0, sampler, dataView))
           anariSetParameter(device, material, "specular", ANARI_SAMPLER, sampler);
         anariRelease(device, sampler);
       }
@@ -396,7 +1931,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       if(aiMaterial->GetTextureCount(aiTextureType_CLEARCOAT) > 0)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
-        if(loadTexture(scene, device, aiMaterial, aiTextureType_CLEARCOAT, 0, sampler))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, aiTextureType_CLEARCOAT, 0, sampler, dataView))
           anariSetParameter(device, material, "clearcoat", ANARI_SAMPLER, sampler);
         anariRelease(device, sampler);
       }
@@ -404,7 +1939,7 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       if(aiMaterial->GetTextureCount(aiTextureType_CLEARCOAT) > 1)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
-        if(loadTexture(scene, device, aiMaterial, AI_MATKEY_CLEARCOAT_ROUGHNESS_TEXTURE, sampler))
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, AI_MATKEY_CLEARCOAT_ROUGHNESS_TEXTURE, sampler, dataView))
           anariSetParameter(device, material, "clearcoatRoughness", ANARI_SAMPLER, sampler);
         anariRelease(device, sampler);
       }else if (aiMaterial->Get(AI_MATKEY_CLEARCOAT_ROUGHNESS_FACTOR, clearcoatRoughnessFactor) == AI_SUCCESS)
@@ -414,17 +1949,402 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
       if(aiMaterial->GetTextureCount(aiTextureType_CLEARCOAT) > 2)
       {
         ANARISampler sampler = anariNewSampler(device, "image2D");
-        if(loadTexture(scene, device, aiMaterial, AI_MATKEY_CLEARCOAT_NORMAL_TEXTURE, sampler))
-          anariSetParameter(device, material, "clearcoatRoughness", ANARI_SAMPLER, sampler);
+        if(loadTexture(scene, device, textures, attributeUsage[index], aiMaterial, AI_MATKEY_CLEARCOAT_NORMAL_TEXTURE, sampler, dataView))
+          anariSetParameter(device, material, "clearcoatNormal", ANARI_SAMPLER, sampler);
         anariRelease(device, sampler);
       }
       
       
       anariCommitParameters(device, material);
       materialsByMaterialId[index] = material;
-      anariRelease(device, material);
     }
   }
+  report->textureCacheHits = textures.hits;
+  report->textureCacheMisses = textures.misses;
+  report->textureDecodeMilliseconds = textures.decodeMilliseconds;
+  report->textureDecodeThreads = pool.size();
+  report->textureFileBytes = textures.fileBytes;
+  report->textureArrayBytes = textures.arrayBytes;
+  report->textureDecodeMegabytesPerSecond = textures.decodeMilliseconds > 0.0 ? textures.decodedBytes / (1000.0 * textures.decodeMilliseconds) : 0.0;
+  if (textures.hits + textures.misses > 0) {
+    std::cerr << "texture cache: " << textures.misses << " images decoded in " << textures.decodeMilliseconds << " ms ("
+              << report->textureDecodeMegabytesPerSecond << " MB/s on " << pool.size() << " threads), " << textures.hits << " reused, "
+              << textures.fileBytes << " bytes read from files, " << textures.arrayBytes << " bytes of image arrays" << std::endl;
+  }
+  // the samplers hold the arrays
+  releaseTextureCache(device, textures);
+
+  // Mesh whose geometry is used by each mesh: itself, or the first identical mesh when deduplicating
+  std::vector<unsigned int> geometrySource(scene->mNumMeshes);
+  if (options.deduplicateMeshes && scene->HasMeshes()) {
+    geometrySource = findDuplicateMeshes(scene, pool);
+  } else {
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      geometrySource[index] = index;
+    }
+  }
+  // Transform from the geometry source to each mesh, identity unless the mesh is a rigid copy
+  std::vector<aiMatrix4x4> meshTransforms(scene->mNumMeshes);
+  std::vector<bool> rigidCopies(scene->mNumMeshes, false);
+  if (options.instanceRigidCopies && scene->HasMeshes()) {
+    const std::vector<unsigned int> exactSource = geometrySource;
+    findRigidCopies(scene, pool, options.rigidCopyTolerance, geometrySource, meshTransforms);
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      // exact duplicates of a rigid copy follow it to its reference (sources always come first)
+      const unsigned int source = geometrySource[index];
+      if (source != index && geometrySource[source] != source) {
+        geometrySource[index] = geometrySource[source];
+        meshTransforms[index] = meshTransforms[source];
+      }
+      rigidCopies[index] = geometrySource[index] != exactSource[index];
+    }
+  }
+
+  if (options.pruneUnusedAttributes || options.generateTangents) {
+    // pruned geometries and generated tangents depend on the material: only share geometries between meshes
+    // reading the same attributes
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      const unsigned int source = geometrySource[index];
+      if (source == index) {
+        continue;
+      }
+      const AttributeUsage& usage = materialUsage(context, scene->mMeshes[index]);
+      const AttributeUsage& sourceUsage = materialUsage(context, scene->mMeshes[source]);
+      if ((options.pruneUnusedAttributes && !sameUsage(usage, sourceUsage)) || !sameUvAttributes(usage, sourceUsage) ||
+          (options.generateTangents && usage.normalMapChannel != sourceUsage.normalMapChannel)) {
+        geometrySource[index] = index;
+        meshTransforms[index] = aiMatrix4x4();
+        rigidCopies[index] = false;
+      }
+    }
+  }
+
+  // Small static meshes baked together; the meshes whose every placement is merged are not converted on their own
+  // (unless another mesh shares their geometry)
+  const std::vector<MeshPlacement> placements = collectPlacements(scene);
+  // Mesh bounds come from the conversion of the positions: grown while they are written, or by a pass of their own
+  // when they are handed as is. Only the merge candidates are bounded ahead of it.
+  report->meshBounds.assign(scene->mNumMeshes, Bounds());
+  // With rebaseMeshOrigins, positions are uploaded relative to the first vertex of their mesh (or geometry source):
+  // a point of the mesh, known before any pass over the positions
+  std::vector<aiVector3D> meshOrigins(scene->mNumMeshes);
+  if (options.rebaseMeshOrigins) {
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      if (scene->mMeshes[index]->mNumVertices > 0) {
+        meshOrigins[index] = scene->mMeshes[index]->mVertices[0];
+      }
+    }
+  }
+  std::vector<bool> mergedPlacements(placements.size(), false);
+  std::vector<bool> converted(scene->mNumMeshes, true);
+  std::shared_ptr<MergedScene> merged = std::make_shared<MergedScene>();
+  merged->scene = owner;
+  if (options.mergeSmallMeshes && scene->HasMeshes()) {
+    merged->meshes = mergePlacements(context, scene, placements, report->meshBounds);
+    for (const MergedMesh& mergedMesh: merged->meshes) {
+      for (size_t placement: mergedMesh.placements) {
+        mergedPlacements[placement] = true;
+      }
+    }
+    std::vector<bool> placed(scene->mNumMeshes, false);
+    std::vector<bool> unmerged(scene->mNumMeshes, false);
+    for (size_t index = 0; index < placements.size(); ++index) {
+      if (placements[index].meshIndex < scene->mNumMeshes) {
+        placed[placements[index].meshIndex] = true;
+        unmerged[placements[index].meshIndex] = unmerged[placements[index].meshIndex] || !mergedPlacements[index];
+      }
+    }
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      converted[index] = !placed[index] || unmerged[index];
+    }
+    for (unsigned int index = 0; index < scene->mNumMeshes; ++index) {
+      if (converted[index]) {
+        converted[geometrySource[index]] = true;
+      }
+    }
+  }
+
+  auto materialOf = [&](const aiMesh* mesh) {
+    if (materialsByMaterialId.count(mesh->mMaterialIndex)) {
+      return materialsByMaterialId[mesh->mMaterialIndex];
+    }
+    // surfaces need a material
+    if (defaultMaterial == nullptr) {
+      defaultMaterial = anariNewMaterial(device, "matte");
+      anariCommitParameters(device, defaultMaterial);
+    }
+    return defaultMaterial;
+  };
+
+  if (scene->HasMeshes()) {
+    // Meshes are converted by batches: the CPU side of a batch runs on the pool,
+    // then the batch is submitted to the device in mesh order from this thread.
+    const size_t batchSize = pool.size() == 1 ? 1 : 4 * pool.size();
+    std::vector<PreparedMesh> batch;
+    for (size_t batchStart = 0; batchStart < scene->mNumMeshes; batchStart += batchSize) {
+      const size_t batchEnd = std::min<size_t>(scene->mNumMeshes, batchStart + batchSize);
+      batch.clear();
+      batch.resize(batchEnd - batchStart);
+      // Large meshes are prepared one at a time from this thread so that their own passes (normal generation,
+      // splitting, array conversion) spread over the pool; nested in the batch loop they would run inline.
+      auto isLarge = [&](size_t index) { return scene->mMeshes[index]->mNumVertices > conversionGrain; };
+      auto isPrepared = [&](size_t index) { return geometrySource[index] == index && converted[index]; };
+      pool.parallelFor(batch.size(), [&](size_t offset) {
+        if (isPrepared(batchStart + offset) && !isLarge(batchStart + offset)) {
+          prepareMesh(context, scene->mMeshes[batchStart + offset], meshOrigins[batchStart + offset], batch[offset]);
+        }
+      });
+      for (size_t offset = 0; offset < batch.size(); ++offset) {
+        if (isPrepared(batchStart + offset) && isLarge(batchStart + offset)) {
+          prepareMesh(context, scene->mMeshes[batchStart + offset], meshOrigins[batchStart + offset], batch[offset]);
+        }
+      }
+
+      for (size_t index = batchStart; index < batchEnd; ++index) {
+        std::cerr << "mesh = " << (index + 1) << "/" << scene->mNumMeshes << std::endl;
+        if (!converted[index]) {
+          std::cerr << "mesh = " << index << " only placed in merged geometries" << std::endl;
+          continue;
+        }
+        const aiMesh* mesh = scene->mMeshes[index];
+        const unsigned int source = geometrySource[index];
+        if (source != index) {
+          if (geometriesByMeshId.count(source) == 0) {
+            continue;
+          }
+          // Duplicate or rigid copy: share the geometries, and the whole group when the material matches too
+          std::cerr << "mesh = " << index << (rigidCopies[index] ? " is a transformed copy of mesh = " : " duplicates mesh = ") << source << std::endl;
+          geometriesByMeshId[index] = geometriesByMeshId[source];
+          for (ANARIGeometry geometry: geometriesByMeshId[index]) {
+            anariRetain(device, geometry);
+          }
+          if (mesh->mMaterialIndex == scene->mMeshes[source]->mMaterialIndex) {
+            groupsByMeshId[index] = groupsByMeshId[source];
+            anariRetain(device, groupsByMeshId[index]);
+          } else {
+            groupsByMeshId[index] = submitGroup(device, geometriesByMeshId[index], materialOf(mesh), surfacesByMeshId[index]);
+          }
+          if (lodGroupsByMeshId.count(source)) {
+            lodGeometriesByMeshId[index] = lodGeometriesByMeshId[source];
+            for (const std::vector<ANARIGeometry>& lod: lodGeometriesByMeshId[index]) {
+              for (ANARIGeometry geometry: lod) {
+                anariRetain(device, geometry);
+              }
+            }
+            for (size_t level = 0; level < lodGeometriesByMeshId[index].size(); ++level) {
+              if (mesh->mMaterialIndex == scene->mMeshes[source]->mMaterialIndex) {
+                lodGroupsByMeshId[index].push_back(lodGroupsByMeshId[source][level]);
+                anariRetain(device, lodGroupsByMeshId[index].back());
+              } else {
+                lodGroupsByMeshId[index].push_back(submitGroup(device, lodGeometriesByMeshId[index][level], materialOf(mesh), surfacesByMeshId[index]));
+              }
+            }
+          }
+          report->meshBounds[index] = rigidCopies[index] ? transformBounds(report->meshBounds[source], meshTransforms[index]) : report->meshBounds[source];
+          if (rigidCopies[index]) {
+            report->rigidCopyMeshes++;
+            report->rigidCopyBytes += meshUploadBytes(mesh);
+          } else {
+            report->deduplicatedMeshes++;
+            report->deduplicatedBytes += meshUploadBytes(mesh);
+          }
+          continue;
+        }
+
+        const PreparedMesh& prepared = batch[index - batchStart];
+        if (prepared.skipped) {
+          continue;
+        }
+        geometriesByMeshId[index] = submitMesh(context, index, prepared);
+        report->meshBounds[index] = offsetBounds(preparedBounds(prepared.geometries), -meshOrigins[index]);
+        if (prepared.welded) {
+          report->weldedMeshes.push_back(prepared.weld);
+          report->weldedMeshes.back().meshIndex = unsigned(index);
+          std::cerr << "welded mesh = " << index << " vertices " << prepared.weld.verticesBefore << " -> " << prepared.weld.verticesAfter
+                    << " triangles " << prepared.weld.trianglesBefore << " -> " << prepared.weld.trianglesAfter
+                    << " in " << prepared.weld.milliseconds << " ms" << std::endl;
+        }
+        report->prunedAttributeBytes += prepared.prunedBytes;
+        groupsByMeshId[index] = submitGroup(device, geometriesByMeshId[index], materialOf(mesh), surfacesByMeshId[index]);
+        for (const std::vector<PreparedGeometry>& lod: prepared.lods) {
+          lodGeometriesByMeshId[index].push_back(submitGeometries(context, index, lod));
+          lodGroupsByMeshId[index].push_back(submitGroup(device, lodGeometriesByMeshId[index].back(), materialOf(mesh), surfacesByMeshId[index]));
+        }
+        if (report->lodLevels.size() < prepared.lodReports.size()) {
+          report->lodLevels.resize(prepared.lodReports.size());
+        }
+        for (size_t level = 0; level < prepared.lodReports.size(); ++level) {
+          report->lodLevels[level].meshes += prepared.lodReports[level].meshes;
+          report->lodLevels[level].triangles += prepared.lodReports[level].triangles;
+          report->lodLevels[level].bytes += prepared.lodReports[level].bytes;
+          report->lodLevels[level].milliseconds += prepared.lodReports[level].milliseconds;
+        }
+      }
+    }
+  }
+
+  // Merged meshes go through the same pipeline, keyed after the scene meshes. Their triangle order is the picking
+  // table order, so they are neither reordered, welded nor clustered. Their arrays share memory with them like with the scene.
+  BridgeOptions mergedOptions = options;
+  mergedOptions.reorderTriangles = false;
+  mergedOptions.weldVertices = false;
+  mergedOptions.clusterTriangles = 0;
+  mergedOptions.lodLevels = 0;
+  const ConversionContext mergedContext = { device, owner ? SceneOwner(merged, scene) : SceneOwner(), pool, mergedOptions,
+                                            geometryMaxIndex, quantizationErrors, attributeUsage };
+  std::vector<aiVector3D> mergedOrigins(merged->meshes.size());
+  if (options.rebaseMeshOrigins) {
+    for (size_t index = 0; index < merged->meshes.size(); ++index) {
+      if (merged->meshes[index].mesh->mNumVertices > 0) {
+        mergedOrigins[index] = merged->meshes[index].mesh->mVertices[0];
+      }
+    }
+  }
+  if (!merged->meshes.empty()) {
+    std::vector<PreparedMesh> prepared(merged->meshes.size());
+    auto isLarge = [&](size_t index) { return merged->meshes[index].mesh->mNumVertices > conversionGrain; };
+    pool.parallelFor(prepared.size(), [&](size_t index) {
+      if (!isLarge(index)) {
+        prepareMesh(mergedContext, merged->meshes[index].mesh.get(), mergedOrigins[index], prepared[index]);
+      }
+    });
+    for (size_t index = 0; index < prepared.size(); ++index) {
+      if (isLarge(index)) {
+        prepareMesh(mergedContext, merged->meshes[index].mesh.get(), mergedOrigins[index], prepared[index]);
+      }
+    }
+    for (size_t index = 0; index < prepared.size(); ++index) {
+      const unsigned int meshId = scene->mNumMeshes + unsigned(index);
+      std::cerr << "merged mesh = " << index << " of " << merged->meshes[index].placements.size() << " placements" << std::endl;
+      geometriesByMeshId[meshId] = submitMesh(mergedContext, meshId, prepared[index]);
+      merged->meshes[index].bounds = offsetBounds(preparedBounds(prepared[index].geometries), -mergedOrigins[index]);
+      report->prunedAttributeBytes += prepared[index].prunedBytes;
+      groupsByMeshId[meshId] = submitGroup(device, geometriesByMeshId[meshId], materialOf(prepared[index].mesh), surfacesByMeshId[meshId]);
+    }
+  }
+
+  // Scene origin: center of the placed meshes, which the instance transforms are relative to
+  if (options.rebaseSceneOrigin) {
+    Bounds sceneBounds;
+    for (const MeshPlacement& placement: placements) {
+      if (placement.meshIndex < scene->mNumMeshes) {
+        growBounds(sceneBounds, transformBounds(report->meshBounds[placement.meshIndex], placement.transform));
+      }
+    }
+    if (!sceneBounds.empty()) {
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        report->sceneOrigin[axis] = 0.5 * (double(sceneBounds.lower[axis]) + double(sceneBounds.upper[axis]));
+      }
+      std::cerr << "scene origin = (" << report->sceneOrigin[0] << ", " << report->sceneOrigin[1] << ", " << report->sceneOrigin[2] << ")" << std::endl;
+    }
+  }
+  // Instance transforms are composed with the mesh origins in double precision, taken relative to the scene origin,
+  // then rounded once. Instances moving with the scene origin keep a retained handle.
+  auto submitRebasedInstance = [&](ANARIGroup group, const double* sceneTransform, const aiMatrix4x4& transform) {
+    ANARIInstance instance = submitInstance(device, group, transform);
+    if (options.rebaseSceneOrigin) {
+      RebasedInstance rebased;
+      rebased.instance = instance;
+      std::copy(sceneTransform, sceneTransform + 16, rebased.transform);
+      anariRetain(device, instance);
+      report->rebasedInstances.push_back(rebased);
+    }
+    return instance;
+  };
+
+  // Instances: one per mesh placement in the node hierarchy, all placements of a mesh share its group,
+  // then one identity instance per merged mesh
+  std::vector<ANARIObject> instances;
+  for (size_t index = 0; index < placements.size(); ++index) {
+    const MeshPlacement& placement = placements[index];
+    if (mergedPlacements[index] || groupsByMeshId.count(placement.meshIndex) == 0) {
+      continue;
+    }
+    const unsigned int source = geometrySource[placement.meshIndex];
+    const aiVector3D& origin = meshOrigins[source];
+    double sceneTransform[16];
+    rebasedTransform(placement.transform * meshTransforms[placement.meshIndex], origin, sceneTransform);
+    const aiMatrix4x4 transform = relativeTransform(sceneTransform, report->sceneOrigin);
+    instances.push_back(submitRebasedInstance(groupsByMeshId[placement.meshIndex], sceneTransform, transform));
+    const Bounds uploadedBounds = offsetBounds(report->meshBounds[source], origin);
+    report->instanceBounds.push_back(transformBounds(uploadedBounds, transform));
+    if (lodGroupsByMeshId.count(placement.meshIndex)) {
+      // Swappable instance: retained handles of the instance and of every level, world space bounding sphere
+      LodInstance lodInstance;
+      lodInstance.instance = ANARIInstance(instances.back());
+      lodInstance.groups.push_back(groupsByMeshId[placement.meshIndex]);
+      for (ANARIGroup group: lodGroupsByMeshId[placement.meshIndex]) {
+        lodInstance.groups.push_back(group);
+      }
+      anariRetain(device, lodInstance.instance);
+      for (ANARIGroup group: lodInstance.groups) {
+        anariRetain(device, group);
+      }
+      boundingSphere(uploadedBounds, transform, lodInstance.center, lodInstance.radius);
+      report->lodInstances.push_back(lodInstance);
+    }
+  }
+  size_t mergedCount = 0;
+  for (size_t index = 0; index < merged->meshes.size(); ++index) {
+    const MergedMesh& mergedMesh = merged->meshes[index];
+    MergedGeometry geometry;
+    geometry.instanceIndex = unsigned(instances.size());
+    geometry.materialIndex = mergedMesh.mesh->mMaterialIndex;
+    uint32_t firstTriangle = 0;
+    for (size_t placement: mergedMesh.placements) {
+      const unsigned int meshIndex = placements[placement].meshIndex;
+      geometry.meshIndices.push_back(meshIndex);
+      geometry.nodes.push_back(placements[placement].node);
+      geometry.firstTriangles.push_back(firstTriangle);
+      firstTriangle += scene->mMeshes[meshIndex]->mNumFaces;
+    }
+    mergedCount += mergedMesh.placements.size();
+    double sceneTransform[16];
+    rebasedTransform(aiMatrix4x4(), mergedOrigins[index], sceneTransform);
+    const aiMatrix4x4 transform = relativeTransform(sceneTransform, report->sceneOrigin);
+    instances.push_back(submitRebasedInstance(groupsByMeshId[scene->mNumMeshes + unsigned(index)], sceneTransform, transform));
+    report->instanceBounds.push_back(transformBounds(offsetBounds(mergedMesh.bounds, mergedOrigins[index]), transform));
+    report->mergedGeometries.push_back(std::move(geometry));
+  }
+  if (options.mergeSmallMeshes) {
+    std::cerr << "merged " << mergedCount << " placements into " << merged->meshes.size() << " geometries" << std::endl;
+  }
+  for (const Bounds& bounds: report->instanceBounds) {
+    growBounds(report->worldBounds, bounds);
+  }
+  std::cerr << "instances = " << instances.size() << " of " << groupsByMeshId.size() << " meshes" << std::endl;
+  if (!report->worldBounds.empty()) {
+    std::cerr << "world bounds = (" << report->worldBounds.lower[0] << ", " << report->worldBounds.lower[1] << ", " << report->worldBounds.lower[2]
+              << ") - (" << report->worldBounds.upper[0] << ", " << report->worldBounds.upper[1] << ", " << report->worldBounds.upper[2] << ")" << std::endl;
+  }
+  if (options.deduplicateMeshes) {
+    std::cerr << "deduplicated meshes = " << report->deduplicatedMeshes << " saving " << report->deduplicatedBytes << " bytes" << std::endl;
+  }
+  if (options.instanceRigidCopies) {
+    std::cerr << "rigid copies = " << report->rigidCopyMeshes << " saving " << report->rigidCopyBytes << " bytes" << std::endl;
+  }
+  for (size_t level = 0; level < report->lodLevels.size(); ++level) {
+    const LodLevelReport& lod = report->lodLevels[level];
+    std::cerr << "level of detail " << level << ": " << lod.meshes << " meshes, " << lod.triangles << " triangles, "
+              << lod.bytes << " bytes, built in " << lod.milliseconds << " ms" << std::endl;
+  }
+  if (options.pruneUnusedAttributes) {
+    std::cerr << "pruned attributes saving " << report->prunedAttributeBytes << " bytes" << std::endl;
+  }
+  if (options.quantizationBits) {
+    report->normalQuantizationError = quantizationErrors.normal.load();
+    report->tangentQuantizationError = quantizationErrors.tangent.load();
+    report->colorQuantizationError = quantizationErrors.color.load();
+    report->uvQuantizationError = quantizationErrors.uv.load();
+    std::cerr << "quantization max error: normal = " << report->normalQuantizationError << " tangent = " << report->tangentQuantizationError
+              << " color = " << report->colorQuantizationError << " uv = " << report->uvQuantizationError << std::endl;
+  }
+
+  if (!instances.empty()) {
+    ANARIArray1D array = newObjectArray1D(device, ANARI_INSTANCE, instances);
+    anariSetParameter(device, world, "instance", ANARI_ARRAY1D, &array);
+    anariRelease(device, array); // we are done using this handle
+  }
 
   scene->HasCameras();
 
@@ -432,12 +2352,127 @@ ANARIWorld assimp_anari_bridge::bridge(const aiScene* scene, ANARIDevice device)
   anariCommitParameters(device, world);
 
   for (auto& pair: geometriesByMeshId) {
-    anariRelease(device, pair.second);
+    for (ANARIGeometry geometry: pair.second) {
+      anariRelease(device, geometry);
+    }
   }
 
   for (auto& pair: materialsByMaterialId) {
     anariRelease(device, pair.second);
   }
 
+  if (defaultMaterial) {
+    anariRelease(device, defaultMaterial);
+  }
+
+  for (auto& pair: surfacesByMeshId) {
+    for (ANARISurface surface: pair.second) {
+      anariRelease(device, surface);
+    }
+  }
+
+  for (auto& pair: groupsByMeshId) {
+    anariRelease(device, pair.second);
+  }
+
+  for (auto& pair: lodGeometriesByMeshId) {
+    for (const std::vector<ANARIGeometry>& lod: pair.second) {
+      for (ANARIGeometry geometry: lod) {
+        anariRelease(device, geometry);
+      }
+    }
+  }
+
+  for (auto& pair: lodGroupsByMeshId) {
+    for (ANARIGroup group: pair.second) {
+      anariRelease(device, group);
+    }
+  }
+
+  for (ANARIObject instance: instances) {
+    anariRelease(device, instance);
+  }
+
+  // Handles only retained for the caller's report
+  if (report == &localReport) {
+    releaseLevelsOfDetail(device, localReport.lodInstances);
+    releaseRebasedInstances(device, localReport.rebasedInstances);
+  }
+
   return world;
 }
+
+unsigned int assimp_anari_bridge::selectLevelsOfDetail(ANARIDevice device, std::vector<LodInstance>& instances, const float* cameraPosition, float detailDistance) {
+  unsigned int changed = 0;
+  for (LodInstance& lodInstance: instances) {
+    if (lodInstance.groups.empty()) {
+      continue;
+    }
+    const float dx = cameraPosition[0] - lodInstance.center[0];
+    const float dy = cameraPosition[1] - lodInstance.center[1];
+    const float dz = cameraPosition[2] - lodInstance.center[2];
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    const float fullDetail = lodInstance.radius * detailDistance;
+    unsigned int level = 0;
+    if (distance > fullDetail && fullDetail > 0.0f) {
+      level = 1 + unsigned(std::log2(distance / fullDetail));
+    }
+    level = std::min<unsigned int>(level, unsigned(lodInstance.groups.size()) - 1);
+    if (level == lodInstance.level) {
+      continue;
+    }
+    anariSetParameter(device, lodInstance.instance, "group", ANARI_GROUP, &lodInstance.groups[level]);
+    anariCommitParameters(device, lodInstance.instance);
+    lodInstance.level = level;
+    ++changed;
+  }
+  return changed;
+}
+
+void assimp_anari_bridge::releaseLevelsOfDetail(ANARIDevice device, std::vector<LodInstance>& instances) {
+  for (LodInstance& lodInstance: instances) {
+    for (ANARIGroup group: lodInstance.groups) {
+      anariRelease(device, group);
+    }
+    anariRelease(device, lodInstance.instance);
+  }
+  instances.clear();
+}
+
+void assimp_anari_bridge::setSceneOrigin(ANARIDevice device, BridgeReport& report, const double* origin) {
+  float shift[3];
+  for (unsigned int axis = 0; axis < 3; ++axis) {
+    shift[axis] = float(report.sceneOrigin[axis] - origin[axis]);
+    report.sceneOrigin[axis] = origin[axis];
+  }
+  for (RebasedInstance& rebased: report.rebasedInstances) {
+    float transform[16];
+    toAnariMatrix(relativeTransform(rebased.transform, report.sceneOrigin), transform);
+    anariSetParameter(device, rebased.instance, "transform", ANARI_FLOAT32_MAT4, transform);
+    anariCommitParameters(device, rebased.instance);
+  }
+  auto shiftBounds = [&](Bounds& bounds) {
+    if (!bounds.empty()) {
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        bounds.lower[axis] += shift[axis];
+        bounds.upper[axis] += shift[axis];
+      }
+    }
+  };
+  for (Bounds& bounds: report.instanceBounds) {
+    shiftBounds(bounds);
+  }
+  shiftBounds(report.worldBounds);
+  for (LodInstance& lodInstance: report.lodInstances) {
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      lodInstance.center[axis] += shift[axis];
+    }
+  }
+}
+
+void assimp_anari_bridge::releaseRebasedInstances(ANARIDevice device, std::vector<RebasedInstance>& instances) {
+  for (RebasedInstance& rebased: instances) {
+    anariRelease(device, rebased.instance);
+  }
+  instances.clear();
+}
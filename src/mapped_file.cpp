@@ -0,0 +1,61 @@
+#include "mapped_file.h"
+
+// std includes
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BRIDGE_HAS_MMAP 1
+#else
+#define BRIDGE_HAS_MMAP 0
+#endif
+
+assimp_anari_bridge::MappedFile::MappedFile(const std::string& path, bool map) {
+#if BRIDGE_HAS_MMAP
+  if (map) {
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+      return;
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) == 0 && status.st_size > 0) {
+      void* address = ::mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (address != MAP_FAILED) {
+        // decoded whole right away: start reading ahead
+        ::madvise(address, size_t(status.st_size), MADV_WILLNEED);
+        mapping = address;
+        length = size_t(status.st_size);
+        isValid = true;
+      }
+    }
+    ::close(descriptor);
+    if (isValid) {
+      return;
+    }
+  }
+#endif
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return;
+  }
+  const std::streamsize size = file.tellg();
+  file.seekg(0, std::ios::beg);
+  buffer.resize(size_t(size));
+  if (size > 0 && !file.read(reinterpret_cast<char*>(buffer.data()), size)) {
+    buffer.clear();
+    return;
+  }
+  length = buffer.size();
+  isValid = true;
+}
+
+assimp_anari_bridge::MappedFile::~MappedFile() {
+#if BRIDGE_HAS_MMAP
+  if (mapping) {
+    ::munmap(mapping, length);
+  }
+#endif
+}
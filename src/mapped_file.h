@@ -0,0 +1,44 @@
+#ifndef _ASSIMP_ANARI_BRIDGE_MAPPED_FILE_H_DEFINED
+#define _ASSIMP_ANARI_BRIDGE_MAPPED_FILE_H_DEFINED
+
+// std includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace assimp_anari_bridge {
+
+  /**
+   * Read-only content of a whole file: memory mapped on POSIX systems, read into memory otherwise
+   * (or when mapping is not asked for or fails). Safe to open concurrently from several threads.
+   **/
+  class MappedFile {
+  public:
+    /**
+     * @param[in] path File to open
+     * @param[in] map Memory map the file when the platform allows it, read it otherwise
+     **/
+    MappedFile(const std::string& path, bool map);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @return true if the file could be opened and read (an empty file is valid)
+     **/
+    bool valid() const { return isValid; }
+
+    const unsigned char* data() const { return mapping ? static_cast<const unsigned char*>(mapping) : buffer.data(); }
+    size_t size() const { return length; }
+
+  private:
+    void* mapping = nullptr;
+    size_t length = 0;
+    std::vector<unsigned char> buffer;
+    bool isValid = false;
+  };
+
+}
+
+#endif
@@ -0,0 +1,502 @@
+#include "mesh_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if BRIDGE_HAS_GATHER_KERNEL
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define BRIDGE_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#elif defined(__GNUC__) || defined(__clang__)
+#define BRIDGE_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define BRIDGE_PREFETCH(address) ((void)(address))
+#endif
+
+namespace {
+  // How many faces ahead the index blocks are prefetched: far enough to hide a cache miss,
+  // close enough for the blocks to still be in cache when reached
+  const size_t prefetchDistance = 16;
+
+  // Faces handled per contiguity check in flattenTriangles(), 16KB of aiFace
+  const size_t flattenChunk = 1024;
+
+  // hashBytes() lane keys and mixing constants (64-bit primes)
+  const uint64_t hashPrime1 = 0x9E3779B185EBCA87ull;
+  const uint64_t hashPrime2 = 0xC2B2AE3D27D4EB4Full;
+  const uint64_t hashPrime3 = 0x165667B19E3779F9ull;
+  const uint64_t hashKeys[8] = {
+    0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+    0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull
+  };
+
+  uint64_t mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= hashPrime2;
+    value ^= value >> 29;
+    value *= hashPrime3;
+    value ^= value >> 32;
+    return value;
+  }
+
+  // One 64-byte stripe: every lane accumulates the 32x32 bit product of its keyed input halves,
+  // and its neighbour accumulates the raw input so that no input bit can cancel out
+  void accumulateStripe(uint64_t* accumulators, const unsigned char* stripe) {
+    uint64_t lanes[8];
+    std::memcpy(lanes, stripe, sizeof(lanes));
+    for (unsigned int lane = 0; lane < 8; ++lane) {
+      const uint64_t keyed = lanes[lane] ^ hashKeys[lane];
+      accumulators[lane ^ 1] += lanes[lane];
+      accumulators[lane] += (keyed & 0xffffffffull) * (keyed >> 32);
+    }
+  }
+
+#if BRIDGE_HAS_GATHER_KERNEL
+  void accumulateStripes(uint64_t* accumulators, const unsigned char* data, size_t stripes) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulators));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulators + 4));
+    const __m256i keysLow = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hashKeys));
+    const __m256i keysHigh = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hashKeys + 4));
+    for (size_t stripe = 0; stripe < stripes; ++stripe, data += 64) {
+      const __m256i inputLow = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+      const __m256i inputHigh = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+      const __m256i keyedLow = _mm256_xor_si256(inputLow, keysLow);
+      const __m256i keyedHigh = _mm256_xor_si256(inputHigh, keysHigh);
+      // swap neighbour lanes (lane ^ 1) and add the products of the 32-bit halves
+      low = _mm256_add_epi64(low, _mm256_permute4x64_epi64(inputLow, _MM_SHUFFLE(2, 3, 0, 1)));
+      high = _mm256_add_epi64(high, _mm256_permute4x64_epi64(inputHigh, _MM_SHUFFLE(2, 3, 0, 1)));
+      low = _mm256_add_epi64(low, _mm256_mul_epu32(keyedLow, _mm256_srli_epi64(keyedLow, 32)));
+      high = _mm256_add_epi64(high, _mm256_mul_epu32(keyedHigh, _mm256_srli_epi64(keyedHigh, 32)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulators), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulators + 4), high);
+  }
+#else
+  void accumulateStripes(uint64_t* accumulators, const unsigned char* data, size_t stripes) {
+    for (size_t stripe = 0; stripe < stripes; ++stripe, data += 64) {
+      accumulateStripe(accumulators, data);
+    }
+  }
+#endif
+}
+
+bool assimp_anari_bridge::trianglesAreContiguous(const aiFace* faces, size_t begin, size_t end) {
+  if (begin >= end) {
+    return true;
+  }
+  const unsigned int* expected = faces[begin].mIndices;
+  for (size_t indexFace = begin; indexFace < end; ++indexFace, expected += 3) {
+    if (faces[indexFace].mIndices != expected || faces[indexFace].mNumIndices != 3) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void assimp_anari_bridge::flattenTriangles(const aiFace* faces, uint32_t* indices, size_t begin, size_t end) {
+  // Work by chunks small enough for the contiguity check to leave the faces in cache for the copy,
+  // this also picks the bulk copy for the contiguous parts of partially contiguous meshes
+  for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += flattenChunk) {
+    const size_t chunkEnd = std::min(end, chunkBegin + flattenChunk);
+    if (trianglesAreContiguous(faces, chunkBegin, chunkEnd)) {
+      std::memcpy(indices + 3 * chunkBegin, faces[chunkBegin].mIndices, (chunkEnd - chunkBegin) * 3 * sizeof(uint32_t));
+      continue;
+    }
+#if BRIDGE_HAS_GATHER_KERNEL
+    flattenTrianglesGather(faces, indices, chunkBegin, chunkEnd);
+#else
+    flattenTrianglesPrefetch(faces, indices, chunkBegin, chunkEnd);
+#endif
+  }
+}
+
+uint64_t assimp_anari_bridge::hashBytes(const void* data, size_t size, uint64_t seed) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  uint64_t accumulators[8];
+  for (unsigned int lane = 0; lane < 8; ++lane) {
+    accumulators[lane] = seed + hashPrime1 * (lane + 1);
+  }
+
+  const size_t stripes = size / 64;
+  accumulateStripes(accumulators, bytes, stripes);
+
+  // zero padded last stripe
+  const size_t tail = size - stripes * 64;
+  if (tail > 0) {
+    unsigned char last[64] = {};
+    std::memcpy(last, bytes + stripes * 64, tail);
+    accumulateStripe(accumulators, last);
+  }
+
+  uint64_t hash = size * hashPrime1;
+  for (unsigned int lane = 0; lane < 8; ++lane) {
+    hash = mix(hash ^ mix(accumulators[lane]));
+  }
+  return hash;
+}
+
+size_t assimp_anari_bridge::normalizedSize(NormalizedFormat format) {
+  return format == NormalizedFormat::SNORM8 || format == NormalizedFormat::UNORM8 ? 1 : 2;
+}
+
+namespace {
+
+  struct FormatRange {
+    float lower;
+    float upper;
+    float scale;
+  };
+
+  FormatRange formatRange(assimp_anari_bridge::NormalizedFormat format) {
+    switch (format) {
+      case assimp_anari_bridge::NormalizedFormat::SNORM8:  return { -1.0f, 1.0f, 127.0f };
+      case assimp_anari_bridge::NormalizedFormat::SNORM16: return { -1.0f, 1.0f, 32767.0f };
+      case assimp_anari_bridge::NormalizedFormat::UNORM8:  return { 0.0f, 1.0f, 255.0f };
+      default:                                             return { 0.0f, 1.0f, 65535.0f };
+    }
+  }
+
+  template <typename T>
+  float quantizeScalar(const float* source, T* destination, size_t count, const FormatRange& range) {
+    float maxError = 0.0f;
+    for (size_t index = 0; index < count; ++index) {
+      const float clamped = std::min(range.upper, std::max(range.lower, source[index]));
+      // nearbyint rounds half to even like the SIMD conversion
+      const float quantized = std::nearbyint(clamped * range.scale);
+      destination[index] = static_cast<T>(quantized);
+      maxError = std::max(maxError, std::fabs(quantized / range.scale - source[index]));
+    }
+    return maxError;
+  }
+
+#if BRIDGE_HAS_GATHER_KERNEL
+  // 8 floats per iteration: clamp, scale, round, pack; returns the largest error and the number of floats done
+  size_t quantizeAVX2(const float* source, void* destination, size_t count, assimp_anari_bridge::NormalizedFormat format,
+                      const FormatRange& range, float& maxError) {
+    const __m256 lower = _mm256_set1_ps(range.lower);
+    const __m256 upper = _mm256_set1_ps(range.upper);
+    const __m256 scale = _mm256_set1_ps(range.scale);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 errors = _mm256_setzero_ps();
+    unsigned char* output = static_cast<unsigned char*>(destination);
+    size_t index = 0;
+    for (; index + 8 <= count; index += 8) {
+      const __m256 values = _mm256_loadu_ps(source + index);
+      const __m256 scaled = _mm256_mul_ps(_mm256_min_ps(upper, _mm256_max_ps(lower, values)), scale);
+      const __m256i quantized = _mm256_cvtps_epi32(scaled);
+      // same expression as the scalar path: quantized / scale - value
+      const __m256 restored = _mm256_div_ps(_mm256_cvtepi32_ps(quantized), scale);
+      errors = _mm256_max_ps(errors, _mm256_and_ps(_mm256_sub_ps(restored, values), absMask));
+      const __m128i low = _mm256_castsi256_si128(quantized);
+      const __m128i high = _mm256_extracti128_si256(quantized, 1);
+      switch (format) {
+        case assimp_anari_bridge::NormalizedFormat::SNORM16:
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2 * index), _mm_packs_epi32(low, high));
+          break;
+        case assimp_anari_bridge::NormalizedFormat::UNORM16:
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2 * index), _mm_packus_epi32(low, high));
+          break;
+        case assimp_anari_bridge::NormalizedFormat::SNORM8: {
+          const __m128i words = _mm_packs_epi32(low, high);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(output + index), _mm_packs_epi16(words, words));
+          break;
+        }
+        case assimp_anari_bridge::NormalizedFormat::UNORM8: {
+          const __m128i words = _mm_packus_epi32(low, high);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(output + index), _mm_packus_epi16(words, words));
+          break;
+        }
+      }
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, errors);
+    for (float error: lanes) {
+      maxError = std::max(maxError, error);
+    }
+    return index;
+  }
+#endif
+
+}
+
+float assimp_anari_bridge::quantizeNormalized(const float* source, void* destination, size_t count, NormalizedFormat format) {
+  const FormatRange range = formatRange(format);
+  float maxError = 0.0f;
+  size_t done = 0;
+#if BRIDGE_HAS_GATHER_KERNEL
+  done = quantizeAVX2(source, destination, count, format, range, maxError);
+#endif
+  unsigned char* output = static_cast<unsigned char*>(destination) + done * normalizedSize(format);
+  float tailError = 0.0f;
+  switch (format) {
+    case NormalizedFormat::SNORM8:  tailError = quantizeScalar(source + done, reinterpret_cast<int8_t*>(output), count - done, range); break;
+    case NormalizedFormat::SNORM16: tailError = quantizeScalar(source + done, reinterpret_cast<int16_t*>(output), count - done, range); break;
+    case NormalizedFormat::UNORM8:  tailError = quantizeScalar(source + done, reinterpret_cast<uint8_t*>(output), count - done, range); break;
+    case NormalizedFormat::UNORM16: tailError = quantizeScalar(source + done, reinterpret_cast<uint16_t*>(output), count - done, range); break;
+  }
+  return std::max(maxError, tailError);
+}
+
+namespace {
+
+  float handedness(const aiVector3D& normal, const aiVector3D& tangent, const aiVector3D& bitangent) {
+    const float x = normal.y * tangent.z - normal.z * tangent.y;
+    const float y = normal.z * tangent.x - normal.x * tangent.z;
+    const float z = normal.x * tangent.y - normal.y * tangent.x;
+    return x * bitangent.x + y * bitangent.y + z * bitangent.z < 0.0f ? -1.0f : 1.0f;
+  }
+
+}
+
+void assimp_anari_bridge::packTangents(const aiVector3D* normals, const aiVector3D* tangents, const aiVector3D* bitangents, size_t numSourceVertices,
+                                       const uint32_t* vertices, float* packed, size_t begin, size_t end) {
+  size_t indexVertex = begin;
+#if BRIDGE_HAS_GATHER_KERNEL
+  // gathers take 32-bit signed float offsets
+  if (numSourceVertices * 3 <= size_t(std::numeric_limits<int32_t>::max())) {
+    const float* normalFloats = reinterpret_cast<const float*>(normals);
+    const float* tangentFloats = reinterpret_cast<const float*>(tangents);
+    const float* bitangentFloats = reinterpret_cast<const float*>(bitangents);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 minusOne = _mm256_set1_ps(-1.0f);
+    for (; indexVertex + 8 <= end; indexVertex += 8) {
+      const __m256i source = vertices ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vertices + indexVertex))
+                                      : _mm256_add_epi32(_mm256_set1_epi32(int(indexVertex)), lanes);
+      const __m256i x = _mm256_mullo_epi32(source, three);
+      const __m256i y = _mm256_add_epi32(x, _mm256_set1_epi32(1));
+      const __m256i z = _mm256_add_epi32(x, _mm256_set1_epi32(2));
+      const __m256 nx = _mm256_i32gather_ps(normalFloats, x, 4);
+      const __m256 ny = _mm256_i32gather_ps(normalFloats, y, 4);
+      const __m256 nz = _mm256_i32gather_ps(normalFloats, z, 4);
+      const __m256 tx = _mm256_i32gather_ps(tangentFloats, x, 4);
+      const __m256 ty = _mm256_i32gather_ps(tangentFloats, y, 4);
+      const __m256 tz = _mm256_i32gather_ps(tangentFloats, z, 4);
+      const __m256 bx = _mm256_i32gather_ps(bitangentFloats, x, 4);
+      const __m256 by = _mm256_i32gather_ps(bitangentFloats, y, 4);
+      const __m256 bz = _mm256_i32gather_ps(bitangentFloats, z, 4);
+      // same operation order as handedness(), without fused multiply-add
+      const __m256 cx = _mm256_sub_ps(_mm256_mul_ps(ny, tz), _mm256_mul_ps(nz, ty));
+      const __m256 cy = _mm256_sub_ps(_mm256_mul_ps(nz, tx), _mm256_mul_ps(nx, tz));
+      const __m256 cz = _mm256_sub_ps(_mm256_mul_ps(nx, ty), _mm256_mul_ps(ny, tx));
+      const __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, bx), _mm256_mul_ps(cy, by)), _mm256_mul_ps(cz, bz));
+      const __m256 sign = _mm256_blendv_ps(one, minusOne, _mm256_cmp_ps(dot, zero, _CMP_LT_OQ));
+      // transpose (tx, ty, tz, sign) into 8 VEC4 tangents
+      const __m256 xy0 = _mm256_unpacklo_ps(tx, ty);
+      const __m256 xy1 = _mm256_unpackhi_ps(tx, ty);
+      const __m256 zw0 = _mm256_unpacklo_ps(tz, sign);
+      const __m256 zw1 = _mm256_unpackhi_ps(tz, sign);
+      const __m256 v0 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0));
+      const __m256 v1 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2));
+      const __m256 v2 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0));
+      const __m256 v3 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2));
+      float* output = packed + 4 * (indexVertex - begin);
+      _mm256_storeu_ps(output,      _mm256_permute2f128_ps(v0, v1, 0x20));
+      _mm256_storeu_ps(output + 8,  _mm256_permute2f128_ps(v2, v3, 0x20));
+      _mm256_storeu_ps(output + 16, _mm256_permute2f128_ps(v0, v1, 0x31));
+      _mm256_storeu_ps(output + 24, _mm256_permute2f128_ps(v2, v3, 0x31));
+    }
+  }
+#else
+  (void)numSourceVertices;   // only bounds the gather offsets
+#endif
+  for (; indexVertex < end; ++indexVertex) {
+    const size_t source = vertices ? vertices[indexVertex] : indexVertex;
+    float* output = packed + 4 * (indexVertex - begin);
+    output[0] = tangents[source].x;
+    output[1] = tangents[source].y;
+    output[2] = tangents[source].z;
+    output[3] = handedness(normals[source], tangents[source], bitangents[source]);
+  }
+}
+
+void assimp_anari_bridge::growBounds(const aiVector3D* points, size_t count, float* lower, float* upper) {
+  const float* coordinates = reinterpret_cast<const float*>(points);
+  size_t done = 0;
+#if BRIDGE_HAS_GATHER_KERNEL
+  if (count >= 8) {
+    // 8 points are 24 floats: lane i of register r holds coordinate (8 * r + i) % 3
+    __m256 minima[3], maxima[3];
+    for (unsigned int r = 0; r < 3; ++r) {
+      minima[r] = maxima[r] = _mm256_loadu_ps(coordinates + 8 * r);
+    }
+    for (done = 8; done + 8 <= count; done += 8) {
+      for (unsigned int r = 0; r < 3; ++r) {
+        const __m256 values = _mm256_loadu_ps(coordinates + 3 * done + 8 * r);
+        minima[r] = _mm256_min_ps(minima[r], values);
+        maxima[r] = _mm256_max_ps(maxima[r], values);
+      }
+    }
+    for (unsigned int r = 0; r < 3; ++r) {
+      float lowerLanes[8], upperLanes[8];
+      _mm256_storeu_ps(lowerLanes, minima[r]);
+      _mm256_storeu_ps(upperLanes, maxima[r]);
+      for (unsigned int lane = 0; lane < 8; ++lane) {
+        const unsigned int axis = (8 * r + lane) % 3;
+        lower[axis] = std::min(lower[axis], lowerLanes[lane]);
+        upper[axis] = std::max(upper[axis], upperLanes[lane]);
+      }
+    }
+  }
+#endif
+  for (size_t point = done; point < count; ++point) {
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      lower[axis] = std::min(lower[axis], coordinates[3 * point + axis]);
+      upper[axis] = std::max(upper[axis], coordinates[3 * point + axis]);
+    }
+  }
+}
+
+void assimp_anari_bridge::offsetPoints(const aiVector3D* points, const uint32_t* vertices, const float* origin, float* offset, size_t begin, size_t end,
+                                       float* lower, float* upper) {
+  size_t point = begin;
+#if BRIDGE_HAS_GATHER_KERNEL
+  if (vertices == nullptr && end - begin >= 8) {
+    // same layout as growBounds: lane i of register r holds coordinate (8 * r + i) % 3
+    const float* coordinates = reinterpret_cast<const float*>(points);
+    __m256 origins[3], minima[3], maxima[3];
+    for (unsigned int r = 0; r < 3; ++r) {
+      float lanes[8];
+      for (unsigned int lane = 0; lane < 8; ++lane) {
+        lanes[lane] = origin[(8 * r + lane) % 3];
+      }
+      origins[r] = _mm256_loadu_ps(lanes);
+      minima[r] = _mm256_set1_ps(std::numeric_limits<float>::max());
+      maxima[r] = _mm256_set1_ps(-std::numeric_limits<float>::max());
+    }
+    for (; point + 8 <= end; point += 8) {
+      for (unsigned int r = 0; r < 3; ++r) {
+        const __m256 values = _mm256_sub_ps(_mm256_loadu_ps(coordinates + 3 * point + 8 * r), origins[r]);
+        _mm256_storeu_ps(offset + 3 * (point - begin) + 8 * r, values);
+        minima[r] = _mm256_min_ps(minima[r], values);
+        maxima[r] = _mm256_max_ps(maxima[r], values);
+      }
+    }
+    for (unsigned int r = 0; r < 3; ++r) {
+      float lowerLanes[8], upperLanes[8];
+      _mm256_storeu_ps(lowerLanes, minima[r]);
+      _mm256_storeu_ps(upperLanes, maxima[r]);
+      for (unsigned int lane = 0; lane < 8; ++lane) {
+        const unsigned int axis = (8 * r + lane) % 3;
+        lower[axis] = std::min(lower[axis], lowerLanes[lane]);
+        upper[axis] = std::max(upper[axis], upperLanes[lane]);
+      }
+    }
+  }
+#endif
+  for (; point < end; ++point) {
+    const aiVector3D& source = points[vertices ? vertices[point] : point];
+    float* output = offset + 3 * (point - begin);
+    output[0] = source.x - origin[0];
+    output[1] = source.y - origin[1];
+    output[2] = source.z - origin[2];
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      lower[axis] = std::min(lower[axis], output[axis]);
+      upper[axis] = std::max(upper[axis], output[axis]);
+    }
+  }
+}
+
+void assimp_anari_bridge::extractChannel(const uint8_t* pixels, size_t count, unsigned int channels, unsigned int channel, uint8_t* plane) {
+  size_t pixel = 0;
+#if BRIDGE_HAS_GATHER_KERNEL
+  if (channels > 1) {
+    // 16 pixels are channels 16-byte registers: byte i of the plane comes from byte (channels * i + channel) % 16 of
+    // register (channels * i + channel) / 16, each register shuffled into place (0x80 clears) and or-ed
+    __m128i masks[4];
+    for (unsigned int r = 0; r < channels; ++r) {
+      alignas(16) int8_t lanes[16];
+      for (unsigned int i = 0; i < 16; ++i) {
+        const unsigned int source = channels * i + channel;
+        lanes[i] = source / 16 == r ? int8_t(source % 16) : int8_t(0x80);
+      }
+      masks[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes));
+    }
+    for (; pixel + 16 <= count; pixel += 16) {
+      const uint8_t* block = pixels + channels * pixel;
+      __m128i result = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), masks[0]);
+      for (unsigned int r = 1; r < channels; ++r) {
+        result = _mm_or_si128(result, _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * r)), masks[r]));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(plane + pixel), result);
+    }
+  }
+#endif
+  for (; pixel < count; ++pixel) {
+    plane[pixel] = pixels[channels * pixel + channel];
+  }
+}
+
+void assimp_anari_bridge::flattenTrianglesScalar(const aiFace* faces, uint32_t* indices, size_t begin, size_t end) {
+  for (size_t indexFace = begin; indexFace < end; ++indexFace) {
+    indices[3 * indexFace]     = faces[indexFace].mIndices[0];
+    indices[3 * indexFace + 1] = faces[indexFace].mIndices[1];
+    indices[3 * indexFace + 2] = faces[indexFace].mIndices[2];
+  }
+}
+
+void assimp_anari_bridge::flattenTrianglesPrefetch(const aiFace* faces, uint32_t* indices, size_t begin, size_t end) {
+  size_t indexFace = begin;
+  for (; indexFace + 4 <= end; indexFace += 4) {
+    if (indexFace + prefetchDistance + 4 <= end) {
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance].mIndices);
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance + 1].mIndices);
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance + 2].mIndices);
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance + 3].mIndices);
+    }
+    const unsigned int* a = faces[indexFace].mIndices;
+    const unsigned int* b = faces[indexFace + 1].mIndices;
+    const unsigned int* c = faces[indexFace + 2].mIndices;
+    const unsigned int* d = faces[indexFace + 3].mIndices;
+    uint32_t* out = indices + 3 * indexFace;
+    out[0] = a[0]; out[1]  = a[1]; out[2]  = a[2];
+    out[3] = b[0]; out[4]  = b[1]; out[5]  = b[2];
+    out[6] = c[0]; out[7]  = c[1]; out[8]  = c[2];
+    out[9] = d[0]; out[10] = d[1]; out[11] = d[2];
+  }
+  flattenTrianglesScalar(faces, indices, indexFace, end);
+}
+
+#if BRIDGE_HAS_GATHER_KERNEL
+void assimp_anari_bridge::flattenTrianglesGather(const aiFace* faces, uint32_t* indices, size_t begin, size_t end) {
+  static_assert(sizeof(aiFace) == 16, "gather kernel expects {uint32 count, pointer} faces");
+  size_t indexFace = begin;
+  for (; indexFace + 4 <= end; indexFace += 4) {
+    if (indexFace + prefetchDistance + 4 <= end) {
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance].mIndices);
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance + 1].mIndices);
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance + 2].mIndices);
+      BRIDGE_PREFETCH(faces[indexFace + prefetchDistance + 3].mIndices);
+    }
+    // 64-bit lanes: {count0, ptr0, count1, ptr1} and {count2, ptr2, count3, ptr3}
+    const __m256i faces01 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(faces + indexFace));
+    const __m256i faces23 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(faces + indexFace + 2));
+    // {ptr0, ptr2, ptr1, ptr3} reordered to {ptr0, ptr1, ptr2, ptr3}
+    const __m256i pointers = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(faces01, faces23), _MM_SHUFFLE(3, 1, 2, 0));
+
+    const __m128i x = _mm256_i64gather_epi32(static_cast<const int*>(nullptr), pointers, 1);
+    const __m128i y = _mm256_i64gather_epi32(static_cast<const int*>(nullptr), _mm256_add_epi64(pointers, _mm256_set1_epi64x(4)), 1);
+    const __m128i z = _mm256_i64gather_epi32(static_cast<const int*>(nullptr), _mm256_add_epi64(pointers, _mm256_set1_epi64x(8)), 1);
+
+    // transpose {x0..x3} {y0..y3} {z0..z3} into x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+    const __m128 xyLow  = _mm_castsi128_ps(_mm_unpacklo_epi32(x, y));
+    const __m128 xyHigh = _mm_castsi128_ps(_mm_unpackhi_epi32(x, y));
+    const __m128 zxLow  = _mm_castsi128_ps(_mm_unpacklo_epi32(z, x));
+    const __m128 zxHigh = _mm_castsi128_ps(_mm_unpackhi_epi32(z, x));
+    const __m128 yzLow  = _mm_castsi128_ps(_mm_unpacklo_epi32(y, z));
+    const __m128 yzHigh = _mm_castsi128_ps(_mm_unpackhi_epi32(y, z));
+    __m128i* out = reinterpret_cast<__m128i*>(indices + 3 * indexFace);
+    _mm_storeu_si128(out,     _mm_castps_si128(_mm_shuffle_ps(xyLow, zxLow, _MM_SHUFFLE(3, 0, 1, 0))));
+    _mm_storeu_si128(out + 1, _mm_castps_si128(_mm_shuffle_ps(yzLow, xyHigh, _MM_SHUFFLE(1, 0, 3, 2))));
+    _mm_storeu_si128(out + 2, _mm_castps_si128(_mm_shuffle_ps(zxHigh, yzHigh, _MM_SHUFFLE(3, 2, 3, 0))));
+  }
+  flattenTrianglesScalar(faces, indices, indexFace, end);
+}
+#endif
@@ -0,0 +1,150 @@
+#ifndef _ASSIMP_ANARI_BRIDGE_MESH_KERNELS_H_DEFINED
+#define _ASSIMP_ANARI_BRIDGE_MESH_KERNELS_H_DEFINED
+
+// assimp includes
+#include <assimp/mesh.h>
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+
+// AVX2 gather kernel, needs 64-bit pointers
+#if defined(__AVX2__) && (defined(__x86_64__) || defined(_M_X64))
+#define BRIDGE_HAS_GATHER_KERNEL 1
+#else
+#define BRIDGE_HAS_GATHER_KERNEL 0
+#endif
+
+namespace assimp_anari_bridge {
+
+  /**
+   * Check whether the index blocks of [begin, end) faces are triangles laid out back to back in memory
+   * (some importers allocate all the indices of a mesh in one block)
+   * @param[in] faces Assimp faces
+   * @param[in] begin First face
+   * @param[in] end Past the last face
+   * @return true if faces[begin].mIndices can be read as one (end - begin) * 3 indices array
+   **/
+  bool trianglesAreContiguous(const aiFace* faces, size_t begin, size_t end);
+
+  /**
+   * Flatten the indices of [begin, end) triangle faces into a UINT32_VEC3 buffer.
+   * Uses a bulk copy when the index blocks are contiguous, otherwise the fastest per-face kernel
+   * available for the target (AVX2 gathers or prefetched unrolled loads).
+   * @param[in] faces Assimp faces, all triangles
+   * @param[out] indices Destination, indexed like faces (indices[3 * begin] receives faces[begin])
+   * @param[in] begin First face
+   * @param[in] end Past the last face
+   **/
+  void flattenTriangles(const aiFace* faces, uint32_t* indices, size_t begin, size_t end);
+
+  /**
+   * Reference one face at a time loop, kept for benchmarking
+   **/
+  void flattenTrianglesScalar(const aiFace* faces, uint32_t* indices, size_t begin, size_t end);
+
+  /**
+   * Per-face kernel unrolled by 4 that prefetches the index blocks of upcoming faces
+   **/
+  void flattenTrianglesPrefetch(const aiFace* faces, uint32_t* indices, size_t begin, size_t end);
+
+  /**
+   * 64-bit hash of a byte range, chaining from seed. Hashes 64-byte stripes on 8 independent
+   * multiply-accumulate lanes (AVX2 when available, with the same result as the scalar path).
+   * Not cryptographic: equal hashes must still be confirmed by comparing the data.
+   * @param[in] data First byte
+   * @param[in] size Number of bytes
+   * @param[in] seed Previous hash when hashing several ranges
+   * @return Hash value
+   **/
+  uint64_t hashBytes(const void* data, size_t size, uint64_t seed);
+
+  /**
+   * Normalized integer formats of quantized attributes (ANARI FIXED / UFIXED types)
+   **/
+  enum class NormalizedFormat {
+    SNORM8,    // int8, [-1, 1] -> [-127, 127]
+    SNORM16,   // int16, [-1, 1] -> [-32767, 32767]
+    UNORM8,    // uint8, [0, 1] -> [0, 255]
+    UNORM16    // uint16, [0, 1] -> [0, 65535]
+  };
+
+  /**
+   * Size in bytes of one component of a normalized format
+   **/
+  size_t normalizedSize(NormalizedFormat format);
+
+  /**
+   * Quantize floats to a normalized integer format, rounding to nearest and clamping to the format range.
+   * Works on 8 floats at a time with AVX2 when available, with the same result as the scalar path.
+   * @param[in] source Floats to quantize
+   * @param[out] destination count components of the format
+   * @param[in] count Number of components
+   * @param[in] format Destination format
+   * @return Largest absolute difference between a source value and its quantized value
+   **/
+  float quantizeNormalized(const float* source, void* destination, size_t count, NormalizedFormat format);
+
+  /**
+   * Pack tangents with their handedness: (tangent, w) where w = +1 when (normal, tangent, bitangent) is right-handed,
+   * -1 otherwise, so that bitangent = w * cross(normal, tangent). Computes 8 vertices at a time with AVX2 gathers
+   * when available, with the same result as the scalar path.
+   * @param[in] normals Source normals
+   * @param[in] tangents Source tangents
+   * @param[in] bitangents Source bitangents
+   * @param[in] numSourceVertices Size of the source arrays
+   * @param[in] vertices Source vertex of each packed vertex, nullptr to read source vertex i for packed vertex i
+   * @param[out] packed end - begin FLOAT32_VEC4 tangents, packed[0] receiving vertex begin
+   * @param[in] begin First packed vertex
+   * @param[in] end Past the last packed vertex
+   **/
+  void packTangents(const aiVector3D* normals, const aiVector3D* tangents, const aiVector3D* bitangents, size_t numSourceVertices,
+                    const uint32_t* vertices, float* packed, size_t begin, size_t end);
+
+  /**
+   * Grow an axis-aligned box to contain points. Works on 8 points (three registers of interleaved coordinates)
+   * at a time with AVX2 when available.
+   * @param[in] points Points
+   * @param[in] count Number of points
+   * @param[in,out] lower Box minimum (3 floats), +max float for an empty box
+   * @param[in,out] upper Box maximum (3 floats), -max float for an empty box
+   **/
+  void growBounds(const aiVector3D* points, size_t count, float* lower, float* upper);
+
+  /**
+   * Subtract an origin from points, growing the box of the output points in the same pass. Works on 8 points
+   * (three registers of interleaved coordinates) at a time with AVX2 when the points are read in order, with the
+   * same result as the scalar path.
+   * @param[in] points Source points
+   * @param[in] vertices Source point of each output point, nullptr to read source point i for output point i
+   * @param[in] origin Subtracted point (3 floats)
+   * @param[out] offset end - begin FLOAT32_VEC3 points, offset[0] receiving point begin
+   * @param[in] begin First output point
+   * @param[in] end Past the last output point
+   * @param[in,out] lower Box minimum of the output points (3 floats), as in growBounds()
+   * @param[in,out] upper Box maximum of the output points (3 floats)
+   **/
+  void offsetPoints(const aiVector3D* points, const uint32_t* vertices, const float* origin, float* offset, size_t begin, size_t end,
+                    float* lower, float* upper);
+
+  /**
+   * Copy one channel of interleaved 8-bit pixels into its own plane. Works on 16 pixels at a time with byte shuffles
+   * (one 16-byte load per channel) with AVX2 builds, with the same result as the scalar path.
+   * @param[in] pixels count pixels of channels bytes each
+   * @param[in] count Number of pixels
+   * @param[in] channels Bytes per pixel, 1 to 4
+   * @param[in] channel Extracted channel, less than channels
+   * @param[out] plane count bytes
+   **/
+  void extractChannel(const uint8_t* pixels, size_t count, unsigned int channels, unsigned int channel, uint8_t* plane);
+
+#if BRIDGE_HAS_GATHER_KERNEL
+  /**
+   * Per-face kernel gathering 4 faces at a time with AVX2, with the same prefetching as flattenTrianglesPrefetch()
+   **/
+  void flattenTrianglesGather(const aiFace* faces, uint32_t* indices, size_t begin, size_t end);
+#endif
+
+}
+
+#endif
@@ -0,0 +1,1315 @@
+#include "mesh_processing.h"
+#include "mesh_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+namespace {
+
+  struct MortonKey {
+    uint64_t code;
+    uint32_t triangle;
+
+    bool operator<(const MortonKey& other) const {
+      return code < other.code || (code == other.code && triangle < other.triangle);
+    }
+  };
+
+  // Spread the lower 21 bits of value so that there are two zero bits between each of them
+  uint64_t spreadBits(uint32_t value) {
+    uint64_t bits = value & 0x1fffff;
+    bits = (bits | bits << 32) & 0x1f00000000ffffull;
+    bits = (bits | bits << 16) & 0x1f0000ff0000ffull;
+    bits = (bits | bits << 8)  & 0x100f00f00f00f00full;
+    bits = (bits | bits << 4)  & 0x10c30c30c30c30c3ull;
+    bits = (bits | bits << 2)  & 0x1249249249249249ull;
+    return bits;
+  }
+
+  // Per-vertex arrays uploaded by the bridge, in a fixed order, null when missing. Every uv set keeps its
+  // slot: channel n is uploaded to its own attribute, so the same data in another channel is other content.
+  std::vector<std::pair<const void*, size_t>> uploadedVertexArrays(const aiMesh* mesh) {
+    std::vector<std::pair<const void*, size_t>> arrays;
+    arrays.push_back({ mesh->mVertices, sizeof(aiVector3D) });
+    arrays.push_back({ mesh->mNormals, sizeof(aiVector3D) });
+    arrays.push_back({ mesh->mTangents, sizeof(aiVector3D) });
+    arrays.push_back({ mesh->mBitangents, sizeof(aiVector3D) });
+    arrays.push_back({ mesh->mColors[0], sizeof(aiColor4D) });
+    for (unsigned int indexUV = 0; indexUV < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++indexUV) {
+      arrays.push_back({ mesh->mTextureCoords[indexUV], sizeof(aiVector3D) });
+    }
+    return arrays;
+  }
+
+  // Orthonormal frame (columns) of a point set from its centroid and two of its vertices
+  struct CanonicalFrame {
+    double origin[3];
+    double axes[3][3];   // axes[i][k]: component i of axis k
+    double scale;        // distance from the centroid to the first vertex
+  };
+
+  bool buildFrame(const aiVector3D* positions, unsigned int numVertices, unsigned int first, unsigned int second, CanonicalFrame& frame) {
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      double sum = 0.0;
+      for (unsigned int indexVertex = 0; indexVertex < numVertices; ++indexVertex) {
+        sum += positions[indexVertex][axis];
+      }
+      frame.origin[axis] = sum / numVertices;
+    }
+    double u[3], v[3];
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      u[axis] = positions[first][axis] - frame.origin[axis];
+      v[axis] = positions[second][axis] - frame.origin[axis];
+    }
+    frame.scale = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+    if (frame.scale == 0.0) {
+      return false;
+    }
+    const double projection = (u[0] * v[0] + u[1] * v[1] + u[2] * v[2]) / (frame.scale * frame.scale);
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      v[axis] -= projection * u[axis];
+    }
+    const double length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (length <= 1e-6 * frame.scale) {
+      return false;
+    }
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      frame.axes[axis][0] = u[axis] / frame.scale;
+      frame.axes[axis][1] = v[axis] / length;
+    }
+    frame.axes[0][2] = frame.axes[1][0] * frame.axes[2][1] - frame.axes[2][0] * frame.axes[1][1];
+    frame.axes[1][2] = frame.axes[2][0] * frame.axes[0][1] - frame.axes[0][0] * frame.axes[2][1];
+    frame.axes[2][2] = frame.axes[0][0] * frame.axes[1][1] - frame.axes[1][0] * frame.axes[0][1];
+    return true;
+  }
+
+  bool sameBytes(const void* first, const void* second, size_t size) {
+    return (first == nullptr) == (second == nullptr) && (first == nullptr || std::memcmp(first, second, size) == 0);
+  }
+
+  // Check that the reference unit vectors, rotated, match the ones of the copy
+  bool unitVectorsMatch(const aiVector3D* reference, const aiVector3D* copy, unsigned int count, const double rotation[3][3], double tolerance) {
+    if ((reference == nullptr) != (copy == nullptr)) {
+      return false;
+    }
+    for (unsigned int index = 0; reference && index < count; ++index) {
+      for (unsigned int row = 0; row < 3; ++row) {
+        const double rotated = rotation[row][0] * reference[index].x + rotation[row][1] * reference[index].y + rotation[row][2] * reference[index].z;
+        if (std::fabs(rotated - copy[index][row]) > tolerance) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Sort runs in parallel, then merge them pairwise, also in parallel
+  template <typename T>
+  void parallelSort(std::vector<T>& values, assimp_anari_bridge::ThreadPool& pool) {
+    const size_t runs = std::min<size_t>(pool.size(), std::max<size_t>(1, values.size() / 4096));
+    const size_t runSize = (values.size() + runs - 1) / runs;
+    pool.parallelForRange(values.size(), runSize, [&](size_t begin, size_t end) {
+      std::sort(values.begin() + begin, values.begin() + end);
+    });
+    for (size_t width = runSize; width < values.size(); width *= 2) {
+      const size_t merges = (values.size() + 2 * width - 1) / (2 * width);
+      pool.parallelFor(merges, [&](size_t merge) {
+        const size_t begin = merge * 2 * width;
+        const size_t middle = std::min(values.size(), begin + width);
+        const size_t end = std::min(values.size(), begin + 2 * width);
+        std::inplace_merge(values.begin() + begin, values.begin() + middle, values.begin() + end);
+      });
+    }
+  }
+
+  // Per-vertex accumulation over the faces of a mesh, with the same float sums whatever the thread count:
+  // the corners of every vertex are gathered in face order, then each vertex sums its own corners on the pool,
+  // in the order of a serial loop over the faces. corners(face) gives the three vertices of a face,
+  // accumulate(sum, face, k) adds corner k of the face to the sum of its vertex.
+  template <typename T, typename Corners, typename Accumulate>
+  void accumulateOverFaces(size_t numFaces, size_t numVertices, assimp_anari_bridge::ThreadPool& pool, const Corners& corners,
+                           T* output, const Accumulate& accumulate) {
+    std::vector<size_t> offsets(numVertices + 1, 0);
+    for (size_t face = 0; face < numFaces; ++face) {
+      const auto* vertices = corners(face);
+      for (unsigned int k = 0; k < 3; ++k) {
+        ++offsets[vertices[k] + 1];
+      }
+    }
+    for (size_t vertex = 0; vertex < numVertices; ++vertex) {
+      offsets[vertex + 1] += offsets[vertex];
+    }
+    std::vector<size_t> vertexCorners(3 * numFaces);
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t face = 0; face < numFaces; ++face) {
+      const auto* vertices = corners(face);
+      for (unsigned int k = 0; k < 3; ++k) {
+        vertexCorners[fill[vertices[k]]++] = 3 * face + k;
+      }
+    }
+    pool.parallelForRange(numVertices, 1 << 12, [&](size_t begin, size_t end) {
+      for (size_t vertex = begin; vertex < end; ++vertex) {
+        T sum = T();
+        for (size_t index = offsets[vertex]; index < offsets[vertex + 1]; ++index) {
+          accumulate(sum, vertexCorners[index] / 3, unsigned(vertexCorners[index] % 3));
+        }
+        output[vertex] = sum;
+      }
+    });
+  }
+
+  // Hash of one vertex over per-vertex streams whose element sizes are multiples of 4 bytes.
+  // hashBytes() is tuned for long ranges, this one mixes 32-bit words and finishes with a 64-bit avalanche.
+  uint64_t hashVertex(const std::vector<std::pair<const void*, size_t>>& streams, size_t vertex) {
+    uint64_t hash = 0x9e3779b97f4a7c15ull;
+    for (const auto& stream: streams) {
+      const unsigned char* element = static_cast<const unsigned char*>(stream.first) + vertex * stream.second;
+      for (size_t offset = 0; offset + 4 <= stream.second; offset += 4) {
+        uint32_t word;
+        std::memcpy(&word, element + offset, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
+        hash ^= hash >> 29;
+      }
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  // Triangles of a mesh: its faces, or the triangles of a base chunk whose vertices index the mesh
+  struct TriangleView {
+    const aiMesh* mesh;
+    const assimp_anari_bridge::MeshChunk* base;
+
+    size_t count() const {
+      return base ? base->indices.size() / 3 : mesh->mNumFaces;
+    }
+
+    size_t numVertices() const {
+      return base ? base->vertices.size() : mesh->mNumVertices;
+    }
+
+    void corners(size_t triangle, uint32_t* corner) const {
+      if (base) {
+        std::memcpy(corner, base->indices.data() + 3 * triangle, 3 * sizeof(uint32_t));
+      } else {
+        std::memcpy(corner, mesh->mFaces[triangle].mIndices, 3 * sizeof(uint32_t));
+      }
+    }
+
+    uint32_t sourceVertex(uint32_t vertex) const {
+      return base ? base->vertices[vertex] : vertex;
+    }
+
+    const aiVector3D& position(uint32_t vertex) const {
+      return mesh->mVertices[sourceVertex(vertex)];
+    }
+  };
+
+  // Angle between two edges leaving the same corner, 0 for degenerate edges
+  float cornerAngle(const aiVector3D& first, const aiVector3D& second) {
+    const float lengths = first.Length() * second.Length();
+    if (!(lengths > 0.0f)) {
+      return 0.0f;
+    }
+    return std::acos(std::min(1.0f, std::max(-1.0f, (first * second) / lengths)));
+  }
+
+  // Component of vector orthogonal to the unit vector normal
+  aiVector3D projectOnPlane(const aiVector3D& vector, const aiVector3D& normal) {
+    return vector - normal * (normal * vector);
+  }
+
+  // Tangent accumulated over the corners of a vertex, orientation > 0 when most of them have a right-handed uv frame
+  struct TangentSum {
+    aiVector3D tangent;
+    float orientation = 0.0f;
+
+    TangentSum& operator+=(const TangentSum& other) {
+      tangent += other.tangent;
+      orientation += other.orientation;
+      return *this;
+    }
+  };
+
+  // Symmetric 4x4 matrix of the summed squared distances to a set of planes (Garland-Heckbert), upper triangle
+  struct Quadric {
+    double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0, a11 = 0.0, a12 = 0.0, a13 = 0.0, a22 = 0.0, a23 = 0.0, a33 = 0.0;
+
+    // Plane (normal, offset) with unit normal, weighted
+    static Quadric plane(const aiVector3D& normal, double offset, double weight) {
+      Quadric quadric;
+      const double a = normal.x, b = normal.y, c = normal.z, d = offset;
+      quadric.a00 = weight * a * a; quadric.a01 = weight * a * b; quadric.a02 = weight * a * c; quadric.a03 = weight * a * d;
+      quadric.a11 = weight * b * b; quadric.a12 = weight * b * c; quadric.a13 = weight * b * d;
+      quadric.a22 = weight * c * c; quadric.a23 = weight * c * d;
+      quadric.a33 = weight * d * d;
+      return quadric;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+      a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+      a11 += other.a11; a12 += other.a12; a13 += other.a13;
+      a22 += other.a22; a23 += other.a23;
+      a33 += other.a33;
+      return *this;
+    }
+
+    double error(const aiVector3D& point) const {
+      const double x = point.x, y = point.y, z = point.z;
+      return a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+           + a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+           + a22 * z * z + 2.0 * a23 * z
+           + a33;
+    }
+  };
+
+  // Edge collapse moving vertex from onto vertex to
+  struct Collapse {
+    float cost;
+    uint32_t from;
+    uint32_t to;
+
+    bool operator<(const Collapse& other) const {
+      return cost < other.cost || (cost == other.cost && (from < other.from || (from == other.from && to < other.to)));
+    }
+  };
+
+}
+
+uint64_t assimp_anari_bridge::mortonCode(uint32_t x, uint32_t y, uint32_t z) {
+  return spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2);
+}
+
+std::vector<uint32_t> assimp_anari_bridge::mortonOrderTriangles(const aiMesh* mesh, ThreadPool& pool, const MeshChunk* base) {
+  const TriangleView triangles = { mesh, base };
+  const size_t numFaces = triangles.count();
+
+  // Bounds of the centroids
+  std::vector<aiVector3D> partialMin(pool.size(), aiVector3D(std::numeric_limits<float>::max()));
+  std::vector<aiVector3D> partialMax(pool.size(), aiVector3D(-std::numeric_limits<float>::max()));
+  std::vector<aiVector3D> centroids(numFaces);
+  const size_t grain = (numFaces + pool.size() - 1) / pool.size();
+  pool.parallelForRange(numFaces, grain, [&](size_t begin, size_t end) {
+    aiVector3D& lower = partialMin[begin / grain];
+    aiVector3D& upper = partialMax[begin / grain];
+    for (size_t indexFace = begin; indexFace < end; ++indexFace) {
+      uint32_t corner[3];
+      triangles.corners(indexFace, corner);
+      const aiVector3D centroid = (triangles.position(corner[0]) + triangles.position(corner[1]) + triangles.position(corner[2])) / 3.0f;
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        lower[axis] = std::min(lower[axis], centroid[axis]);
+        upper[axis] = std::max(upper[axis], centroid[axis]);
+      }
+      centroids[indexFace] = centroid;
+    }
+  });
+  aiVector3D lower = partialMin[0];
+  aiVector3D upper = partialMax[0];
+  for (size_t part = 1; part < partialMin.size(); ++part) {
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+      lower[axis] = std::min(lower[axis], partialMin[part][axis]);
+      upper[axis] = std::max(upper[axis], partialMax[part][axis]);
+    }
+  }
+
+  // Quantize the centroids on a 2^21 grid over the bounds
+  aiVector3D scale;
+  for (unsigned int axis = 0; axis < 3; ++axis) {
+    const float extent = upper[axis] - lower[axis];
+    scale[axis] = extent > 0.0f ? float((1 << 21) - 1) / extent : 0.0f;
+  }
+  std::vector<MortonKey> keys(numFaces);
+  pool.parallelForRange(numFaces, grain, [&](size_t begin, size_t end) {
+    for (size_t indexFace = begin; indexFace < end; ++indexFace) {
+      const aiVector3D& centroid = centroids[indexFace];
+      keys[indexFace].code = mortonCode(uint32_t((centroid.x - lower.x) * scale.x),
+                                        uint32_t((centroid.y - lower.y) * scale.y),
+                                        uint32_t((centroid.z - lower.z) * scale.z));
+      keys[indexFace].triangle = uint32_t(indexFace);
+    }
+  });
+  parallelSort(keys, pool);
+
+  std::vector<uint32_t> order(numFaces);
+  for (size_t indexFace = 0; indexFace < numFaces; ++indexFace) {
+    order[indexFace] = keys[indexFace].triangle;
+  }
+  return order;
+}
+
+std::vector<assimp_anari_bridge::MeshChunk> assimp_anari_bridge::splitMesh(const aiMesh* mesh, uint64_t maxVertices, ThreadPool& pool, const MeshChunk* base) {
+  const TriangleView triangles = { mesh, base };
+  const std::vector<uint32_t> order = mortonOrderTriangles(mesh, pool, base);
+  const uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+  maxVertices = std::max<uint64_t>(3, maxVertices);
+
+  // Greedy packing along the curve: a chunk is closed when the next triangle would overflow its vertex budget.
+  // localIndex is only valid for vertices whose chunkOfVertex is the current chunk.
+  std::vector<MeshChunk> chunks(1);
+  std::vector<uint32_t> chunkOfVertex(triangles.numVertices(), unassigned);
+  std::vector<uint32_t> localIndex(triangles.numVertices());
+  for (uint32_t triangle: order) {
+    uint32_t corner[3];
+    triangles.corners(triangle, corner);
+    uint32_t chunk = uint32_t(chunks.size() - 1);
+    uint64_t newVertices = 0;
+    for (unsigned int c = 0; c < 3; ++c) {
+      const bool repeated = (c > 0 && corner[c] == corner[0]) || (c > 1 && corner[c] == corner[1]);
+      if (!repeated && chunkOfVertex[corner[c]] != chunk) {
+        ++newVertices;
+      }
+    }
+    if (chunks.back().vertices.size() + newVertices > maxVertices) {
+      chunks.emplace_back();
+      ++chunk;
+    }
+    MeshChunk& current = chunks.back();
+    for (unsigned int c = 0; c < 3; ++c) {
+      const uint32_t vertex = corner[c];
+      if (chunkOfVertex[vertex] != chunk) {
+        chunkOfVertex[vertex] = chunk;
+        localIndex[vertex] = uint32_t(current.vertices.size());
+        current.vertices.push_back(triangles.sourceVertex(vertex));
+      }
+      current.indices.push_back(localIndex[vertex]);
+    }
+  }
+  return chunks;
+}
+
+std::vector<assimp_anari_bridge::MeshChunk> assimp_anari_bridge::clusterMesh(const aiMesh* mesh, size_t maxTriangles, ThreadPool& pool, const MeshChunk* base) {
+  const TriangleView triangles = { mesh, base };
+  const size_t numTriangles = triangles.count();
+  maxTriangles = std::max<size_t>(1, maxTriangles);
+  const size_t grain = 1 << 16;
+
+  std::vector<aiVector3D> centroids(numTriangles);
+  std::vector<uint32_t> order(numTriangles);
+  pool.parallelForRange(numTriangles, grain, [&](size_t begin, size_t end) {
+    for (size_t triangle = begin; triangle < end; ++triangle) {
+      uint32_t corner[3];
+      triangles.corners(triangle, corner);
+      centroids[triangle] = (triangles.position(corner[0]) + triangles.position(corner[1]) + triangles.position(corner[2])) / 3.0f;
+      order[triangle] = uint32_t(triangle);
+    }
+  });
+
+  // Bounds of triangles (or centroids) and triangle count of a bin
+  struct Bin {
+    aiVector3D lower = aiVector3D(std::numeric_limits<float>::max());
+    aiVector3D upper = aiVector3D(-std::numeric_limits<float>::max());
+    size_t count = 0;
+
+    void grow(const aiVector3D& point) {
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        lower[axis] = std::min(lower[axis], point[axis]);
+        upper[axis] = std::max(upper[axis], point[axis]);
+      }
+    }
+
+    void merge(const Bin& other) {
+      if (other.count) {
+        grow(other.lower);
+        grow(other.upper);
+        count += other.count;
+      }
+    }
+
+    // In double: float products overflow for coordinates beyond about 1e19
+    double halfArea() const {
+      const double x = double(upper.x) - lower.x, y = double(upper.y) - lower.y, z = double(upper.z) - lower.z;
+      return count ? x * y + y * z + z * x : 0.0;
+    }
+  };
+  const unsigned int numBins = 32;
+  typedef std::array<Bin, numBins> Bins;
+
+  // Split [begin, end) of order in two along the widest centroid axis, returns where the second part starts
+  auto split = [&](size_t begin, size_t end) {
+    const size_t count = end - begin;
+    const size_t rangeCount = (count + grain - 1) / grain;
+
+    std::vector<Bin> centroidBounds(rangeCount);
+    pool.parallelForRange(count, grain, [&](size_t rangeBegin, size_t rangeEnd) {
+      Bin& bounds = centroidBounds[rangeBegin / grain];
+      for (size_t index = begin + rangeBegin; index < begin + rangeEnd; ++index) {
+        bounds.grow(centroids[order[index]]);
+      }
+      bounds.count = rangeEnd - rangeBegin;
+    });
+    Bin bounds;
+    for (const Bin& range: centroidBounds) {
+      bounds.merge(range);
+    }
+    const aiVector3D extent = bounds.upper - bounds.lower;
+    const unsigned int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    if (!(extent[axis] > 0.0f)) {
+      // Every centroid at the same place: median split in triangle order
+      return begin + count / 2;
+    }
+    const float lower = bounds.lower[axis];
+    const float scale = numBins / extent[axis];
+    auto binOf = [&](uint32_t triangle) {
+      return std::min(numBins - 1, unsigned((centroids[triangle][axis] - lower) * scale));
+    };
+
+    // Triangle bounds binned on their centroid
+    std::vector<Bins> rangeBins(rangeCount);
+    pool.parallelForRange(count, grain, [&](size_t rangeBegin, size_t rangeEnd) {
+      Bins& bins = rangeBins[rangeBegin / grain];
+      for (size_t index = begin + rangeBegin; index < begin + rangeEnd; ++index) {
+        uint32_t corner[3];
+        triangles.corners(order[index], corner);
+        Bin& bin = bins[binOf(order[index])];
+        for (unsigned int c = 0; c < 3; ++c) {
+          bin.grow(triangles.position(corner[c]));
+        }
+        ++bin.count;
+      }
+    });
+    Bins bins;
+    for (const Bins& range: rangeBins) {
+      for (unsigned int bin = 0; bin < numBins; ++bin) {
+        bins[bin].merge(range[bin]);
+      }
+    }
+
+    // Cheapest plane: left bins [0, plane), right bins [plane, numBins)
+    std::array<double, numBins> rightCosts;
+    Bin right;
+    for (unsigned int plane = numBins - 1; plane > 0; --plane) {
+      right.merge(bins[plane]);
+      rightCosts[plane] = right.halfArea() * double(right.count);
+    }
+    double bestCost = std::numeric_limits<double>::max();
+    unsigned int bestPlane = 0;
+    Bin left;
+    for (unsigned int plane = 1; plane < numBins; ++plane) {
+      left.merge(bins[plane - 1]);
+      const double cost = left.halfArea() * double(left.count) + rightCosts[plane];
+      if (left.count > 0 && left.count < count && cost < bestCost) {
+        bestCost = cost;
+        bestPlane = plane;
+      }
+    }
+    if (bestPlane == 0) {
+      // No finite cost (or every triangle in one bin): median split, so that the range always shrinks
+      return begin + count / 2;
+    }
+    return size_t(std::partition(order.begin() + begin, order.begin() + end, [&](uint32_t triangle) {
+      return binOf(triangle) < bestPlane;
+    }) - order.begin());
+  };
+
+  // Top-down, one tree level at a time
+  std::vector<std::pair<size_t, size_t>> leaves;
+  std::vector<std::pair<size_t, size_t>> level;
+  if (numTriangles > 0) {
+    level.push_back({ 0, numTriangles });
+  }
+  while (!level.empty()) {
+    std::vector<size_t> middles(level.size());
+    pool.parallelFor(level.size(), [&](size_t node) {
+      if (level[node].second - level[node].first > maxTriangles) {
+        middles[node] = split(level[node].first, level[node].second);
+      }
+    });
+    std::vector<std::pair<size_t, size_t>> next;
+    for (size_t node = 0; node < level.size(); ++node) {
+      if (level[node].second - level[node].first > maxTriangles) {
+        next.push_back({ level[node].first, middles[node] });
+        next.push_back({ middles[node], level[node].second });
+      } else {
+        leaves.push_back(level[node]);
+      }
+    }
+    level.swap(next);
+  }
+  std::sort(leaves.begin(), leaves.end());
+
+  // Chunk of each leaf, vertices in first use order (a linear pass, as splitMesh())
+  const uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+  std::vector<MeshChunk> chunks(leaves.size());
+  std::vector<uint32_t> chunkOfVertex(triangles.numVertices(), unassigned);
+  std::vector<uint32_t> localIndex(triangles.numVertices());
+  for (size_t leaf = 0; leaf < leaves.size(); ++leaf) {
+    MeshChunk& chunk = chunks[leaf];
+    chunk.indices.resize(3 * (leaves[leaf].second - leaves[leaf].first));
+    uint32_t* corner = chunk.indices.data();
+    for (size_t index = leaves[leaf].first; index < leaves[leaf].second; ++index, corner += 3) {
+      triangles.corners(order[index], corner);
+      for (unsigned int c = 0; c < 3; ++c) {
+        const uint32_t vertex = corner[c];
+        if (chunkOfVertex[vertex] != leaf) {
+          chunkOfVertex[vertex] = uint32_t(leaf);
+          localIndex[vertex] = uint32_t(chunk.vertices.size());
+          chunk.vertices.push_back(triangles.sourceVertex(vertex));
+        }
+        corner[c] = localIndex[vertex];
+      }
+    }
+  }
+  return chunks;
+}
+
+assimp_anari_bridge::MeshChunk assimp_anari_bridge::simplifyMesh(const aiMesh* mesh, size_t targetTriangles, ThreadPool& pool, const MeshChunk* base) {
+  const TriangleView triangles = { mesh, base };
+  const size_t numVertices = triangles.numVertices();
+  const size_t grain = 1 << 16;
+
+  std::vector<uint32_t> indices(3 * triangles.count());
+  pool.parallelForRange(triangles.count(), grain, [&](size_t begin, size_t end) {
+    for (size_t triangle = begin; triangle < end; ++triangle) {
+      triangles.corners(triangle, indices.data() + 3 * triangle);
+    }
+  });
+  std::vector<aiVector3D> positions(numVertices);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    for (size_t vertex = begin; vertex < end; ++vertex) {
+      positions[vertex] = triangles.position(uint32_t(vertex));
+    }
+  });
+
+  // Vertices that never move: attribute seams (another vertex at the same position) and borders (edges of one triangle)
+  std::vector<unsigned char> locked(numVertices, 0);
+  std::vector<std::pair<std::array<float, 3>, uint32_t>> byPosition(numVertices);
+  for (size_t vertex = 0; vertex < numVertices; ++vertex) {
+    byPosition[vertex] = { { positions[vertex].x, positions[vertex].y, positions[vertex].z }, uint32_t(vertex) };
+  }
+  parallelSort(byPosition, pool);
+  for (size_t index = 1; index < numVertices; ++index) {
+    if (byPosition[index].first == byPosition[index - 1].first) {
+      locked[byPosition[index].second] = locked[byPosition[index - 1].second] = 1;
+    }
+  }
+  std::vector<std::pair<uint32_t, uint32_t>> edges(indices.size());
+  for (size_t corner = 0; corner < indices.size(); ++corner) {
+    const uint32_t first = indices[corner], second = indices[corner % 3 == 2 ? corner - 2 : corner + 1];
+    edges[corner] = { std::min(first, second), std::max(first, second) };
+  }
+  parallelSort(edges, pool);
+  for (size_t index = 0; index < edges.size();) {
+    size_t next = index + 1;
+    while (next < edges.size() && edges[next] == edges[index]) {
+      ++next;
+    }
+    if (next - index == 1) {
+      locked[edges[index].first] = locked[edges[index].second] = 1;
+    }
+    index = next;
+  }
+
+  // Quadric of each vertex: planes of its triangles, weighted by their area
+  std::vector<Quadric> quadrics(numVertices);
+  auto triangleCorners = [&](size_t triangle) {
+    return indices.data() + 3 * triangle;
+  };
+  accumulateOverFaces(indices.size() / 3, numVertices, pool, triangleCorners, quadrics.data(), [&](Quadric& sum, size_t triangle, unsigned int) {
+    const uint32_t* corner = indices.data() + 3 * triangle;
+    aiVector3D normal = (positions[corner[1]] - positions[corner[0]]) ^ (positions[corner[2]] - positions[corner[0]]);
+    const float doubleArea = normal.Length();
+    if (!(doubleArea > 0.0f)) {
+      return;
+    }
+    normal /= doubleArea;
+    sum += Quadric::plane(normal, -(normal * positions[corner[0]]), 0.5 * doubleArea);
+  });
+
+  std::vector<uint32_t> adjacencyOffsets(numVertices + 1);
+  std::vector<uint32_t> adjacency;
+  std::vector<Collapse> collapses;
+  std::vector<unsigned char> touched(numVertices);
+  std::vector<uint32_t> remap(numVertices);
+  const float noCollapse = std::numeric_limits<float>::max();
+  while (indices.size() / 3 > targetTriangles) {
+    const size_t numTriangles = indices.size() / 3;
+
+    // Triangles around each vertex
+    std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+    for (uint32_t vertex: indices) {
+      ++adjacencyOffsets[vertex + 1];
+    }
+    for (size_t vertex = 0; vertex < numVertices; ++vertex) {
+      adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+    }
+    adjacency.resize(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t corner = 0; corner < indices.size(); ++corner) {
+      adjacency[fill[indices[corner]]++] = uint32_t(corner / 3);
+    }
+
+    // Cheapest direction of every triangle edge, then all of them in cost order
+    collapses.resize(indices.size());
+    pool.parallelForRange(numTriangles, grain, [&](size_t begin, size_t end) {
+      for (size_t corner = 3 * begin; corner < 3 * end; ++corner) {
+        const uint32_t first = indices[corner], second = indices[corner % 3 == 2 ? corner - 2 : corner + 1];
+        Quadric sum = quadrics[first];
+        sum += quadrics[second];
+        Collapse collapse = { noCollapse, first, second };
+        if (!locked[first]) {
+          collapse.cost = float(sum.error(positions[second]));
+        }
+        if (!locked[second]) {
+          const float cost = float(sum.error(positions[first]));
+          if (cost < collapse.cost) {
+            collapse = { cost, second, first };
+          }
+        }
+        collapses[corner] = collapse;
+      }
+    });
+    parallelSort(collapses, pool);
+
+    // Independent collapses: disjoint one-rings, no flipped or sliver triangle
+    std::fill(touched.begin(), touched.end(), 0);
+    for (size_t vertex = 0; vertex < numVertices; ++vertex) {
+      remap[vertex] = uint32_t(vertex);
+    }
+    const size_t wanted = (numTriangles - targetTriangles + 1) / 2;   // an interior collapse removes two triangles
+    size_t applied = 0;
+    for (const Collapse& collapse: collapses) {
+      if (collapse.cost == noCollapse || applied >= wanted) {
+        break;
+      }
+      if (touched[collapse.from] || touched[collapse.to] || collapse.from == collapse.to) {
+        continue;
+      }
+      bool flips = false;
+      for (uint32_t offset = adjacencyOffsets[collapse.from]; offset < adjacencyOffsets[collapse.from + 1] && !flips; ++offset) {
+        const uint32_t* corner = indices.data() + 3 * adjacency[offset];
+        if (corner[0] == collapse.to || corner[1] == collapse.to || corner[2] == collapse.to) {
+          continue;   // disappears
+        }
+        aiVector3D moved[3] = { positions[corner[0]], positions[corner[1]], positions[corner[2]] };
+        const aiVector3D before = (moved[1] - moved[0]) ^ (moved[2] - moved[0]);
+        for (unsigned int c = 0; c < 3; ++c) {
+          if (corner[c] == collapse.from) {
+            moved[c] = positions[collapse.to];
+          }
+        }
+        const aiVector3D after = (moved[1] - moved[0]) ^ (moved[2] - moved[0]);
+        // slivers count as flips: twice the area below 1e-3 times the squared longest edge
+        const float longestEdge = std::max((moved[1] - moved[0]).SquareLength(), std::max((moved[2] - moved[1]).SquareLength(), (moved[0] - moved[2]).SquareLength()));
+        flips = !(before * after > 0.0f) || after.Length() < 1e-3f * longestEdge;
+      }
+      if (flips) {
+        continue;
+      }
+      for (uint32_t offset = adjacencyOffsets[collapse.from]; offset < adjacencyOffsets[collapse.from + 1]; ++offset) {
+        const uint32_t* corner = indices.data() + 3 * adjacency[offset];
+        touched[corner[0]] = touched[corner[1]] = touched[corner[2]] = 1;
+      }
+      touched[collapse.to] = 1;
+      remap[collapse.from] = collapse.to;
+      quadrics[collapse.to] += quadrics[collapse.from];
+      ++applied;
+    }
+    if (applied == 0) {
+      break;
+    }
+
+    // Remap the corners, drop the triangles that became degenerate
+    pool.parallelForRange(indices.size(), grain, [&](size_t begin, size_t end) {
+      for (size_t corner = begin; corner < end; ++corner) {
+        indices[corner] = remap[indices[corner]];
+      }
+    });
+    size_t kept = 0;
+    for (size_t triangle = 0; triangle < numTriangles; ++triangle) {
+      const uint32_t* corner = indices.data() + 3 * triangle;
+      if (corner[0] != corner[1] && corner[1] != corner[2] && corner[2] != corner[0]) {
+        std::memmove(indices.data() + 3 * kept++, corner, 3 * sizeof(uint32_t));
+      }
+    }
+    indices.resize(3 * kept);
+  }
+
+  // Kept vertices in first use order
+  const uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+  MeshChunk chunk;
+  std::vector<uint32_t>& localIndex = remap;
+  std::fill(localIndex.begin(), localIndex.end(), unassigned);
+  chunk.indices.resize(indices.size());
+  for (size_t corner = 0; corner < indices.size(); ++corner) {
+    const uint32_t vertex = indices[corner];
+    if (localIndex[vertex] == unassigned) {
+      localIndex[vertex] = uint32_t(chunk.vertices.size());
+      chunk.vertices.push_back(triangles.sourceVertex(vertex));
+    }
+    chunk.indices[corner] = localIndex[vertex];
+  }
+  return chunk;
+}
+
+void assimp_anari_bridge::generateSmoothNormals(const aiMesh* mesh, float creaseAngle, ThreadPool& pool, aiVector3D* normals) {
+  const size_t numVertices = mesh->mNumVertices;
+  const size_t numFaces = mesh->mFaces ? mesh->mNumFaces : 0;
+
+  // Sum angle-weighted face normals
+  auto faceCorners = [&](size_t indexFace) {
+    return mesh->mFaces[indexFace].mIndices;
+  };
+  accumulateOverFaces(numFaces, numVertices, pool, faceCorners, normals, [&](aiVector3D& sum, size_t indexFace, unsigned int k) {
+    const unsigned int* corner = mesh->mFaces[indexFace].mIndices;
+    const aiVector3D& a = mesh->mVertices[corner[0]];
+    const aiVector3D& b = mesh->mVertices[corner[1]];
+    const aiVector3D& c = mesh->mVertices[corner[2]];
+    aiVector3D faceNormal = (b - a) ^ (c - a);
+    const float length = faceNormal.Length();
+    if (!(length > 0.0f)) {
+      return;
+    }
+    faceNormal /= length;
+    const aiVector3D* points[3] = { &a, &b, &c };
+    sum += faceNormal * cornerAngle(*points[(k + 1) % 3] - *points[k], *points[(k + 2) % 3] - *points[k]);
+  });
+
+  const size_t grain = 1 << 14;
+
+  // Vertices at the same position: sort them by position, then merge normals within the crease angle inside each group
+  std::vector<std::pair<std::array<float, 3>, uint32_t>> byPosition(numVertices);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      const aiVector3D& position = mesh->mVertices[indexVertex];
+      byPosition[indexVertex] = { { position.x, position.y, position.z }, uint32_t(indexVertex) };
+    }
+  });
+  parallelSort(byPosition, pool);
+  std::vector<size_t> groupStarts;
+  for (size_t index = 0; index < numVertices; ++index) {
+    if (index == 0 || byPosition[index].first != byPosition[index - 1].first) {
+      groupStarts.push_back(index);
+    }
+  }
+  groupStarts.push_back(numVertices);
+
+  // own: accumulated normal of each vertex, direction: the same normalized, zero for degenerate vertices
+  std::vector<aiVector3D> own(normals, normals + numVertices);
+  std::vector<aiVector3D> direction(numVertices);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      const float length = own[indexVertex].Length();
+      direction[indexVertex] = length > 0.0f ? own[indexVertex] / length : aiVector3D(0.0f, 0.0f, 0.0f);
+    }
+  });
+  const float creaseCosine = creaseAngle >= 180.0f ? -2.0f : std::cos(creaseAngle * float(AI_MATH_PI) / 180.0f);
+  pool.parallelForRange(groupStarts.size() - 1, 1024, [&](size_t begin, size_t end) {
+    for (size_t group = begin; group < end; ++group) {
+      for (size_t member = groupStarts[group]; member < groupStarts[group + 1]; ++member) {
+        const uint32_t vertex = byPosition[member].second;
+        // summed in group order, so that vertices merging the same set get bit-identical normals (and can be welded)
+        aiVector3D sum(0.0f, 0.0f, 0.0f);
+        for (size_t other = groupStarts[group]; other < groupStarts[group + 1]; ++other) {
+          const uint32_t otherVertex = byPosition[other].second;
+          if (otherVertex == vertex || direction[otherVertex] * direction[vertex] >= creaseCosine) {
+            sum += own[otherVertex];
+          }
+        }
+        const float length = sum.Length();
+        normals[vertex] = length > 0.0f ? sum / length : aiVector3D(0.0f, 0.0f, 1.0f);
+      }
+    }
+  });
+}
+
+void assimp_anari_bridge::generateTangents(const aiMesh* mesh, const aiVector3D* normals, const aiVector3D* uvs, ThreadPool& pool, float* tangents) {
+  const size_t numVertices = mesh->mNumVertices;
+  const size_t numFaces = mesh->mFaces ? mesh->mNumFaces : 0;
+
+  // Per corner, as MikkTSpace: the uv-gradient tangent of the face projected on the vertex normal plane,
+  // normalized and weighted by the corner angle measured in that plane
+  std::vector<TangentSum> sums(numVertices);
+  auto faceCorners = [&](size_t indexFace) {
+    return mesh->mFaces[indexFace].mIndices;
+  };
+  accumulateOverFaces(numFaces, numVertices, pool, faceCorners, sums.data(), [&](TangentSum& sum, size_t indexFace, unsigned int k) {
+    const unsigned int* corner = mesh->mFaces[indexFace].mIndices;
+    const aiVector3D edge1 = mesh->mVertices[corner[1]] - mesh->mVertices[corner[0]];
+    const aiVector3D edge2 = mesh->mVertices[corner[2]] - mesh->mVertices[corner[0]];
+    const float s1 = uvs[corner[1]].x - uvs[corner[0]].x;
+    const float t1 = uvs[corner[1]].y - uvs[corner[0]].y;
+    const float s2 = uvs[corner[2]].x - uvs[corner[0]].x;
+    const float t2 = uvs[corner[2]].y - uvs[corner[0]].y;
+    const float signedArea = s1 * t2 - t1 * s2;
+    if (signedArea == 0.0f) {
+      return;   // degenerate uv mapping, no tangent direction
+    }
+    // d(position)/du up to the signed uv area, whose sign is applied per corner
+    const aiVector3D faceTangent = edge1 * t2 - edge2 * t1;
+    const float orientation = signedArea > 0.0f ? 1.0f : -1.0f;
+    const unsigned int vertex = corner[k];
+    const aiVector3D& normal = normals[vertex];
+    aiVector3D tangent = projectOnPlane(faceTangent, normal);
+    const float length = tangent.Length();
+    if (!(length > 0.0f)) {
+      return;
+    }
+    const aiVector3D& position = mesh->mVertices[vertex];
+    const float angle = cornerAngle(projectOnPlane(mesh->mVertices[corner[(k + 1) % 3]] - position, normal),
+                                    projectOnPlane(mesh->mVertices[corner[(k + 2) % 3]] - position, normal));
+    sum.tangent += tangent * (orientation * angle / length);
+    sum.orientation += orientation * angle;
+  });
+
+  pool.parallelForRange(numVertices, 1 << 14, [&](size_t begin, size_t end) {
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      const aiVector3D& normal = normals[indexVertex];
+      aiVector3D tangent = projectOnPlane(sums[indexVertex].tangent, normal);
+      float length = tangent.Length();
+      if (!(length > 0.0f)) {
+        // no uv gradient: any direction of the normal plane
+        tangent = projectOnPlane(std::fabs(normal.x) < 0.9f ? aiVector3D(1.0f, 0.0f, 0.0f) : aiVector3D(0.0f, 1.0f, 0.0f), normal);
+        length = tangent.Length();
+      }
+      tangent /= length > 0.0f ? length : 1.0f;
+      float* output = tangents + 4 * indexVertex;
+      output[0] = tangent.x;
+      output[1] = tangent.y;
+      output[2] = tangent.z;
+      output[3] = sums[indexVertex].orientation < 0.0f ? -1.0f : 1.0f;
+    }
+  });
+}
+
+assimp_anari_bridge::MeshChunk assimp_anari_bridge::weldMesh(const aiMesh* mesh, const std::vector<std::pair<const void*, size_t>>& streams, ThreadPool& pool) {
+  const size_t numVertices = mesh->mNumVertices;
+  const size_t numFaces = mesh->mNumFaces;
+  const size_t grain = 1 << 14;
+  const size_t ranges = (numVertices + grain - 1) / grain;
+
+  auto sameVertex = [&](uint32_t first, uint32_t second) {
+    for (const auto& stream: streams) {
+      const unsigned char* data = static_cast<const unsigned char*>(stream.first);
+      if (std::memcmp(data + first * stream.second, data + second * stream.second, stream.second) != 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Hash every vertex over all its streams
+  std::vector<uint64_t> hashes(numVertices);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      hashes[indexVertex] = hashVertex(streams, indexVertex);
+    }
+  });
+
+  // Partition the vertices on the top bits of their hash, keeping vertex order inside a partition.
+  // At least 4 partitions per thread, and small enough for their table to stay in cache.
+  unsigned int partitionBits = 0;
+  while (((size_t(1) << partitionBits) < 4 * size_t(pool.size()) || (numVertices >> partitionBits) > (1 << 15)) && partitionBits < 12) {
+    ++partitionBits;
+  }
+  const size_t numPartitions = size_t(1) << partitionBits;
+  auto partitionOf = [&](size_t indexVertex) { return partitionBits ? size_t(hashes[indexVertex] >> (64 - partitionBits)) : 0; };
+  std::vector<uint32_t> counts(ranges * numPartitions, 0);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    uint32_t* rangeCounts = counts.data() + (begin / grain) * numPartitions;
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      ++rangeCounts[partitionOf(indexVertex)];
+    }
+  });
+  std::vector<size_t> partitionStarts(numPartitions + 1, 0);
+  std::vector<size_t> offsets(ranges * numPartitions);
+  size_t offset = 0;
+  for (size_t partition = 0; partition < numPartitions; ++partition) {
+    partitionStarts[partition] = offset;
+    for (size_t range = 0; range < ranges; ++range) {
+      offsets[range * numPartitions + partition] = offset;
+      offset += counts[range * numPartitions + partition];
+    }
+  }
+  partitionStarts[numPartitions] = offset;
+  std::vector<uint32_t> partitioned(numVertices);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    size_t* rangeOffsets = offsets.data() + (begin / grain) * numPartitions;
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      partitioned[rangeOffsets[partitionOf(indexVertex)]++] = uint32_t(indexVertex);
+    }
+  });
+
+  // Each partition builds its own open addressing table: the representative of a vertex is the first equal one
+  std::vector<uint32_t> representative(numVertices);
+  pool.parallelFor(numPartitions, [&](size_t partition) {
+    const size_t begin = partitionStarts[partition];
+    const size_t end = partitionStarts[partition + 1];
+    size_t capacity = 16;
+    while (capacity < 2 * (end - begin)) {
+      capacity *= 2;
+    }
+    const uint32_t empty = std::numeric_limits<uint32_t>::max();
+    std::vector<std::pair<uint64_t, uint32_t>> table(capacity, { 0, empty });
+    for (size_t entry = begin; entry < end; ++entry) {
+      const uint32_t vertex = partitioned[entry];
+      const uint64_t hash = hashes[vertex];
+      size_t slot = size_t(hash) & (capacity - 1);
+      while (true) {
+        std::pair<uint64_t, uint32_t>& candidate = table[slot];
+        if (candidate.second == empty) {
+          candidate = { hash, vertex };
+          representative[vertex] = vertex;
+          break;
+        }
+        if (candidate.first == hash && sameVertex(candidate.second, vertex)) {
+          representative[vertex] = candidate.second;
+          break;
+        }
+        slot = (slot + 1) & (capacity - 1);
+      }
+    }
+  });
+  hashes.clear();
+  partitioned.clear();
+
+  // Drop the triangles collapsed by the weld or with coincident corners, mark the vertices still referenced
+  std::unique_ptr<std::atomic<uint8_t>[]> referenced(new std::atomic<uint8_t>[numVertices]);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      referenced[indexVertex].store(0, std::memory_order_relaxed);
+    }
+  });
+  std::vector<uint8_t> keep(numFaces);
+  pool.parallelForRange(numFaces, grain, [&](size_t begin, size_t end) {
+    for (size_t indexFace = begin; indexFace < end; ++indexFace) {
+      const unsigned int* corner = mesh->mFaces[indexFace].mIndices;
+      const uint32_t a = representative[corner[0]];
+      const uint32_t b = representative[corner[1]];
+      const uint32_t c = representative[corner[2]];
+      const aiVector3D* positions = mesh->mVertices;
+      keep[indexFace] = !(a == b || b == c || a == c || positions[a] == positions[b] || positions[b] == positions[c] || positions[a] == positions[c]);
+      if (keep[indexFace]) {
+        referenced[a].store(1, std::memory_order_relaxed);
+        referenced[b].store(1, std::memory_order_relaxed);
+        referenced[c].store(1, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  // Compact the vertices in their original order, then the triangles, both with per-range prefix sums
+  MeshChunk welded;
+  std::vector<size_t> rangeStarts(ranges + 1, 0);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    size_t count = 0;
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      count += referenced[indexVertex].load(std::memory_order_relaxed);
+    }
+    rangeStarts[begin / grain + 1] = count;
+  });
+  for (size_t range = 0; range < ranges; ++range) {
+    rangeStarts[range + 1] += rangeStarts[range];
+  }
+  welded.vertices.resize(rangeStarts[ranges]);
+  std::vector<uint32_t> newIndex(numVertices);
+  pool.parallelForRange(numVertices, grain, [&](size_t begin, size_t end) {
+    size_t next = rangeStarts[begin / grain];
+    for (size_t indexVertex = begin; indexVertex < end; ++indexVertex) {
+      if (referenced[indexVertex].load(std::memory_order_relaxed)) {
+        newIndex[indexVertex] = uint32_t(next);
+        welded.vertices[next++] = uint32_t(indexVertex);
+      }
+    }
+  });
+
+  const size_t faceRanges = (numFaces + grain - 1) / grain;
+  std::vector<size_t> faceStarts(faceRanges + 1, 0);
+  pool.parallelForRange(numFaces, grain, [&](size_t begin, size_t end) {
+    faceStarts[begin / grain + 1] = size_t(std::count(keep.begin() + begin, keep.begin() + end, uint8_t(1)));
+  });
+  for (size_t range = 0; range < faceRanges; ++range) {
+    faceStarts[range + 1] += faceStarts[range];
+  }
+  welded.indices.resize(3 * faceStarts[faceRanges]);
+  pool.parallelForRange(numFaces, grain, [&](size_t begin, size_t end) {
+    uint32_t* output = welded.indices.data() + 3 * faceStarts[begin / grain];
+    for (size_t indexFace = begin; indexFace < end; ++indexFace) {
+      if (keep[indexFace]) {
+        const unsigned int* corner = mesh->mFaces[indexFace].mIndices;
+        *output++ = newIndex[representative[corner[0]]];
+        *output++ = newIndex[representative[corner[1]]];
+        *output++ = newIndex[representative[corner[2]]];
+      }
+    }
+  });
+  return welded;
+}
+
+uint64_t assimp_anari_bridge::meshContentHash(const aiMesh* mesh) {
+  uint64_t hash = hashBytes(&mesh->mNumVertices, sizeof(mesh->mNumVertices), mesh->mNumFaces);
+  for (const auto& array: uploadedVertexArrays(mesh)) {
+    // missing arrays still change the chain
+    hash = array.first ? hashBytes(array.first, size_t(mesh->mNumVertices) * array.second, hash) : hashBytes(&hash, sizeof(hash), 0);
+  }
+  if (mesh->mFaces) {
+    uint32_t indices[3 * 1024];
+    for (size_t begin = 0; begin < mesh->mNumFaces; begin += 1024) {
+      const size_t end = std::min<size_t>(mesh->mNumFaces, begin + 1024);
+      flattenTriangles(mesh->mFaces + begin, indices, 0, end - begin);
+      hash = hashBytes(indices, (end - begin) * 3 * sizeof(uint32_t), hash);
+    }
+  }
+  return hash;
+}
+
+bool assimp_anari_bridge::meshesHaveSameContent(const aiMesh* first, const aiMesh* second) {
+  if (first->mNumVertices != second->mNumVertices || first->mNumFaces != second->mNumFaces || first->mPrimitiveTypes != second->mPrimitiveTypes
+      || (first->mFaces == nullptr) != (second->mFaces == nullptr)) {
+    return false;
+  }
+  const auto firstArrays = uploadedVertexArrays(first);
+  const auto secondArrays = uploadedVertexArrays(second);
+  if (firstArrays.size() != secondArrays.size()) {
+    return false;
+  }
+  for (size_t index = 0; index < firstArrays.size(); ++index) {
+    if ((firstArrays[index].first == nullptr) != (secondArrays[index].first == nullptr)) {
+      return false;
+    }
+    if (firstArrays[index].first && std::memcmp(firstArrays[index].first, secondArrays[index].first, size_t(first->mNumVertices) * firstArrays[index].second) != 0) {
+      return false;
+    }
+  }
+  for (unsigned int indexFace = 0; first->mFaces && indexFace < first->mNumFaces; ++indexFace) {
+    if (std::memcmp(first->mFaces[indexFace].mIndices, second->mFaces[indexFace].mIndices, 3 * sizeof(unsigned int)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t assimp_anari_bridge::meshUploadBytes(const aiMesh* mesh) {
+  uint64_t bytes = 0;
+  const auto arrays = uploadedVertexArrays(mesh);
+  for (size_t index = 0; index < arrays.size(); ++index) {
+    if (arrays[index].first) {
+      // uv sets are uploaded as FLOAT32_VEC2
+      bytes += uint64_t(mesh->mNumVertices) * (index >= 5 ? 2 * sizeof(float) : arrays[index].second);
+    }
+  }
+  if (mesh->mFaces) {
+    bytes += uint64_t(mesh->mNumFaces) * 3 * sizeof(uint32_t);
+  }
+  return bytes;
+}
+
+uint64_t assimp_anari_bridge::meshTopologyHash(const aiMesh* mesh) {
+  const uint32_t presence = (mesh->mNormals != nullptr) | (mesh->mTangents != nullptr) << 1 | (mesh->mBitangents != nullptr) << 2 | (mesh->mFaces != nullptr) << 3;
+  uint64_t hash = hashBytes(&presence, sizeof(presence), (uint64_t(mesh->mNumVertices) << 32) | mesh->mNumFaces);
+  const auto arrays = uploadedVertexArrays(mesh);
+  // colors and uv sets, positions to bitangents can be transformed
+  for (size_t index = 4; index < arrays.size(); ++index) {
+    hash = arrays[index].first ? hashBytes(arrays[index].first, size_t(mesh->mNumVertices) * arrays[index].second, hash) : hashBytes(&hash, sizeof(hash), 0);
+  }
+  if (mesh->mFaces) {
+    uint32_t indices[3 * 1024];
+    for (size_t begin = 0; begin < mesh->mNumFaces; begin += 1024) {
+      const size_t end = std::min<size_t>(mesh->mNumFaces, begin + 1024);
+      flattenTriangles(mesh->mFaces + begin, indices, 0, end - begin);
+      hash = hashBytes(indices, (end - begin) * 3 * sizeof(uint32_t), hash);
+    }
+  }
+  return hash;
+}
+
+bool assimp_anari_bridge::findSimilarityTransform(const aiMesh* reference, const aiMesh* copy, float tolerance, aiMatrix4x4& transform) {
+  const unsigned int numVertices = reference->mNumVertices;
+  if (numVertices < 3 || numVertices != copy->mNumVertices || reference->mNumFaces != copy->mNumFaces
+      || (reference->mFaces == nullptr) != (copy->mFaces == nullptr)) {
+    return false;
+  }
+
+  // What a transform does not change must be identical
+  const auto referenceArrays = uploadedVertexArrays(reference);
+  const auto copyArrays = uploadedVertexArrays(copy);
+  if (referenceArrays.size() != copyArrays.size()) {
+    return false;
+  }
+  for (size_t index = 4; index < referenceArrays.size(); ++index) {
+    if (!sameBytes(referenceArrays[index].first, copyArrays[index].first, size_t(numVertices) * referenceArrays[index].second)) {
+      return false;
+    }
+  }
+  for (unsigned int indexFace = 0; reference->mFaces && indexFace < reference->mNumFaces; ++indexFace) {
+    if (std::memcmp(reference->mFaces[indexFace].mIndices, copy->mFaces[indexFace].mIndices, 3 * sizeof(unsigned int)) != 0) {
+      return false;
+    }
+  }
+
+  // Frame vertices picked on the reference: the farthest from the centroid, then the farthest from that axis
+  const aiVector3D* positions = reference->mVertices;
+  aiVector3D centroid(0.0f);
+  for (unsigned int indexVertex = 0; indexVertex < numVertices; ++indexVertex) {
+    centroid += positions[indexVertex];
+  }
+  centroid = centroid / float(numVertices);
+  unsigned int first = 0;
+  for (unsigned int indexVertex = 1; indexVertex < numVertices; ++indexVertex) {
+    if ((positions[indexVertex] - centroid).SquareLength() > (positions[first] - centroid).SquareLength()) {
+      first = indexVertex;
+    }
+  }
+  aiVector3D axis = positions[first] - centroid;
+  axis.NormalizeSafe();
+  unsigned int second = 0;
+  float secondDistance = -1.0f;
+  for (unsigned int indexVertex = 0; indexVertex < numVertices; ++indexVertex) {
+    const aiVector3D offset = positions[indexVertex] - centroid;
+    const float distance = (offset - axis * (offset * axis)).SquareLength();
+    if (distance > secondDistance) {
+      second = indexVertex;
+      secondDistance = distance;
+    }
+  }
+
+  CanonicalFrame from, to;
+  if (!buildFrame(reference->mVertices, numVertices, first, second, from) || !buildFrame(copy->mVertices, numVertices, first, second, to)) {
+    return false;
+  }
+
+  // x_copy = to.origin + scale * R * (x_reference - from.origin), with R = to.axes * transpose(from.axes)
+  const double scale = to.scale / from.scale;
+  double rotation[3][3];
+  for (unsigned int row = 0; row < 3; ++row) {
+    for (unsigned int column = 0; column < 3; ++column) {
+      rotation[row][column] = to.axes[row][0] * from.axes[column][0] + to.axes[row][1] * from.axes[column][1] + to.axes[row][2] * from.axes[column][2];
+    }
+  }
+  double translation[3];
+  for (unsigned int row = 0; row < 3; ++row) {
+    translation[row] = to.origin[row] - scale * (rotation[row][0] * from.origin[0] + rotation[row][1] * from.origin[1] + rotation[row][2] * from.origin[2]);
+  }
+
+  // Verification on every vertex
+  double radius = 0.0;
+  for (unsigned int indexVertex = 0; indexVertex < numVertices; ++indexVertex) {
+    for (unsigned int row = 0; row < 3; ++row) {
+      radius = std::max(radius, std::fabs(copy->mVertices[indexVertex][row] - to.origin[row]));
+    }
+  }
+  const double positionTolerance = tolerance * radius;
+  for (unsigned int indexVertex = 0; indexVertex < numVertices; ++indexVertex) {
+    const aiVector3D& source = positions[indexVertex];
+    for (unsigned int row = 0; row < 3; ++row) {
+      const double mapped = translation[row] + scale * (rotation[row][0] * source.x + rotation[row][1] * source.y + rotation[row][2] * source.z);
+      if (std::fabs(mapped - copy->mVertices[indexVertex][row]) > positionTolerance) {
+        return false;
+      }
+    }
+  }
+  if (!unitVectorsMatch(reference->mNormals, copy->mNormals, numVertices, rotation, tolerance)
+      || !unitVectorsMatch(reference->mTangents, copy->mTangents, numVertices, rotation, tolerance)
+      || !unitVectorsMatch(reference->mBitangents, copy->mBitangents, numVertices, rotation, tolerance)) {
+    return false;
+  }
+
+  transform = aiMatrix4x4();
+  for (unsigned int row = 0; row < 3; ++row) {
+    for (unsigned int column = 0; column < 3; ++column) {
+      transform[row][column] = float(scale * rotation[row][column]);
+    }
+    transform[row][3] = float(translation[row]);
+  }
+  return true;
+}
+
+std::unique_ptr<aiMesh> assimp_anari_bridge::mergePlacedMeshes(const std::vector<PlacedMesh>& parts, ThreadPool& pool) {
+  std::unique_ptr<aiMesh> merged(new aiMesh());
+  if (parts.empty()) {
+    return merged;
+  }
+  const aiMesh* first = parts.front().mesh;
+
+  // Where each part starts in the merged arrays
+  std::vector<size_t> firstVertices(parts.size() + 1, 0);
+  std::vector<size_t> firstFaces(parts.size() + 1, 0);
+  for (size_t part = 0; part < parts.size(); ++part) {
+    firstVertices[part + 1] = firstVertices[part] + parts[part].mesh->mNumVertices;
+    firstFaces[part + 1] = firstFaces[part] + parts[part].mesh->mNumFaces;
+  }
+  const size_t numVertices = firstVertices.back();
+  const size_t numFaces = firstFaces.back();
+
+  merged->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+  merged->mMaterialIndex = first->mMaterialIndex;
+  merged->mNumVertices = unsigned(numVertices);
+  merged->mNumFaces = unsigned(numFaces);
+  merged->mVertices = new aiVector3D[numVertices];
+  merged->mNormals = first->mNormals ? new aiVector3D[numVertices] : nullptr;
+  merged->mTangents = first->mTangents ? new aiVector3D[numVertices] : nullptr;
+  merged->mBitangents = first->mBitangents ? new aiVector3D[numVertices] : nullptr;
+  merged->mColors[0] = first->mColors[0] ? new aiColor4D[numVertices] : nullptr;
+  for (unsigned int channel = 0; channel < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++channel) {
+    merged->mTextureCoords[channel] = first->mTextureCoords[channel] ? new aiVector3D[numVertices] : nullptr;
+    merged->mNumUVComponents[channel] = first->mNumUVComponents[channel];
+  }
+  merged->mFaces = new aiFace[numFaces];
+
+  pool.parallelFor(parts.size(), [&](size_t part) {
+    const aiMesh* mesh = parts[part].mesh;
+    const aiMatrix4x4& transform = parts[part].transform;
+    const size_t vertexOffset = firstVertices[part];
+    const size_t faceOffset = firstFaces[part];
+
+    // Directions: linear part for tangents, inverse transpose for normals (cofactors, oriented by the determinant)
+    float linear[3][3];
+    for (unsigned int row = 0; row < 3; ++row) {
+      for (unsigned int column = 0; column < 3; ++column) {
+        linear[row][column] = transform[row][column];
+      }
+    }
+    float cofactors[3][3];
+    for (unsigned int row = 0; row < 3; ++row) {
+      for (unsigned int column = 0; column < 3; ++column) {
+        const unsigned int r1 = (row + 1) % 3, r2 = (row + 2) % 3, c1 = (column + 1) % 3, c2 = (column + 2) % 3;
+        cofactors[row][column] = linear[r1][c1] * linear[r2][c2] - linear[r1][c2] * linear[r2][c1];
+      }
+    }
+    const float determinant = linear[0][0] * cofactors[0][0] + linear[0][1] * cofactors[0][1] + linear[0][2] * cofactors[0][2];
+    const float orientation = determinant < 0.0f ? -1.0f : 1.0f;
+    auto transformDirection = [](const float (&matrix)[3][3], const aiVector3D& direction, float scale) {
+      aiVector3D result(scale * (matrix[0][0] * direction.x + matrix[0][1] * direction.y + matrix[0][2] * direction.z),
+                        scale * (matrix[1][0] * direction.x + matrix[1][1] * direction.y + matrix[1][2] * direction.z),
+                        scale * (matrix[2][0] * direction.x + matrix[2][1] * direction.y + matrix[2][2] * direction.z));
+      return result.NormalizeSafe();
+    };
+
+    for (size_t vertex = 0; vertex < mesh->mNumVertices; ++vertex) {
+      merged->mVertices[vertexOffset + vertex] = transform * mesh->mVertices[vertex];
+      if (merged->mNormals) {
+        merged->mNormals[vertexOffset + vertex] = transformDirection(cofactors, mesh->mNormals[vertex], orientation);
+      }
+      if (merged->mTangents) {
+        merged->mTangents[vertexOffset + vertex] = transformDirection(linear, mesh->mTangents[vertex], 1.0f);
+      }
+      if (merged->mBitangents) {
+        merged->mBitangents[vertexOffset + vertex] = transformDirection(linear, mesh->mBitangents[vertex], 1.0f);
+      }
+    }
+    if (merged->mColors[0]) {
+      std::copy(mesh->mColors[0], mesh->mColors[0] + mesh->mNumVertices, merged->mColors[0] + vertexOffset);
+    }
+    for (unsigned int channel = 0; channel < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++channel) {
+      if (merged->mTextureCoords[channel]) {
+        std::copy(mesh->mTextureCoords[channel], mesh->mTextureCoords[channel] + mesh->mNumVertices, merged->mTextureCoords[channel] + vertexOffset);
+      }
+    }
+    for (size_t face = 0; face < mesh->mNumFaces; ++face) {
+      aiFace& mergedFace = merged->mFaces[faceOffset + face];
+      mergedFace.mNumIndices = 3;
+      mergedFace.mIndices = new unsigned int[3];   // one block per face: ~aiFace frees it
+      for (unsigned int corner = 0; corner < 3; ++corner) {
+        mergedFace.mIndices[corner] = unsigned(vertexOffset + mesh->mFaces[face].mIndices[corner]);
+      }
+    }
+  });
+  return merged;
+}
@@ -0,0 +1,180 @@
+#ifndef _ASSIMP_ANARI_BRIDGE_MESH_PROCESSING_H_DEFINED
+#define _ASSIMP_ANARI_BRIDGE_MESH_PROCESSING_H_DEFINED
+
+// assimp includes
+#include <assimp/mesh.h>
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace assimp_anari_bridge {
+
+  /**
+   * Part of a mesh converted as its own geometry
+   **/
+  struct MeshChunk {
+    std::vector<uint32_t> vertices;   // source vertex of each chunk vertex
+    std::vector<uint32_t> indices;    // chunk-local triangle indices, 3 per triangle
+  };
+
+  /**
+   * Triangle mesh placed in world space by a node
+   **/
+  struct PlacedMesh {
+    const aiMesh* mesh;
+    aiMatrix4x4 transform;
+  };
+
+  /**
+   * Hash of everything the bridge uploads for a triangle mesh: positions, normals, tangents,
+   * bitangents, first color set, every uv set in its channel and triangle indices
+   * @param[in] mesh Triangle mesh
+   * @return Content hash, equal for meshes with the same content
+   **/
+  uint64_t meshContentHash(const aiMesh* mesh);
+
+  /**
+   * Exact comparison of what the bridge uploads for two triangle meshes
+   * @return true if both meshes would produce the same arrays
+   **/
+  bool meshesHaveSameContent(const aiMesh* first, const aiMesh* second);
+
+  /**
+   * Hash of the parts of a triangle mesh that a transform cannot change: vertex and triangle counts,
+   * triangle indices, attribute presence, colors and uv sets. Meshes that are transformed copies of
+   * each other have the same topology hash.
+   * @param[in] mesh Triangle mesh
+   * @return Topology hash
+   **/
+  uint64_t meshTopologyHash(const aiMesh* mesh);
+
+  /**
+   * Find the similarity transform (rotation, uniform scale, translation) that maps a reference mesh onto
+   * a copy with the same topology. The transform is taken from canonical frames built on the same three
+   * vertices of both meshes, then verified on every position, normal, tangent and bitangent.
+   * @param[in] reference Reference triangle mesh
+   * @param[in] copy Candidate copy, vertex i of copy corresponding to vertex i of reference
+   * @param[in] tolerance Allowed position error relative to the bounding radius of the copy, and allowed
+   *                      error on unit vectors (normals, tangents, bitangents)
+   * @param[out] transform Transform mapping reference onto copy when found
+   * @return true if copy is a transformed reference within tolerance
+   **/
+  bool findSimilarityTransform(const aiMesh* reference, const aiMesh* copy, float tolerance, aiMatrix4x4& transform);
+
+  /**
+   * Size of the arrays the bridge uploads for a triangle mesh
+   * @return Number of bytes
+   **/
+  uint64_t meshUploadBytes(const aiMesh* mesh);
+
+  /**
+   * Interleave the bits of three 21-bit integers into a 63-bit Morton (Z-order) code
+   **/
+  uint64_t mortonCode(uint32_t x, uint32_t y, uint32_t z);
+
+  /**
+   * Order the triangles of a mesh along the Morton curve of their centroids
+   * @param[in] mesh Triangle mesh
+   * @param[in] pool Worker threads
+   * @param[in] base Optional chunk whose triangles are ordered instead of the mesh faces
+   * @return Triangle indices, spatially sorted
+   **/
+  std::vector<uint32_t> mortonOrderTriangles(const aiMesh* mesh, ThreadPool& pool, const MeshChunk* base = nullptr);
+
+  /**
+   * Split a triangle mesh into spatially coherent chunks referencing at most maxVertices vertices each.
+   * Triangles are visited along the Morton curve of their centroids and greedily packed into chunks.
+   * @param[in] mesh Triangle mesh
+   * @param[in] maxVertices Vertex budget of a chunk, at least 3 (no budget only reorders the mesh, as one chunk)
+   * @param[in] pool Worker threads
+   * @param[in] base Optional chunk (typically a welded mesh) split instead of the mesh faces
+   * @return Chunks covering every triangle of the mesh (or base) exactly once, their vertices indexing the mesh
+   **/
+  std::vector<MeshChunk> splitMesh(const aiMesh* mesh, uint64_t maxVertices, ThreadPool& pool, const MeshChunk* base = nullptr);
+
+  /**
+   * Split a triangle mesh into spatial clusters of at most maxTriangles triangles each, with a top-down binned SAH
+   * (surface area heuristic) build binning the widest centroid axis. The nodes of a tree level are split in parallel,
+   * or binned in parallel ranges while a level has a single node. Chunk vertices are in first use order.
+   * @param[in] mesh Triangle mesh
+   * @param[in] maxTriangles Triangle budget of a cluster, at least 1
+   * @param[in] pool Worker threads
+   * @param[in] base Optional chunk (typically a welded mesh) clustered instead of the mesh faces
+   * @return Clusters covering every triangle of the mesh (or base) exactly once, in tree order, their vertices indexing the mesh
+   **/
+  std::vector<MeshChunk> clusterMesh(const aiMesh* mesh, size_t maxTriangles, ThreadPool& pool, const MeshChunk* base = nullptr);
+
+  /**
+   * Simplify a triangle mesh down to about targetTriangles with quadric error metrics (Garland-Heckbert): edges
+   * collapse onto one of their vertices, cheapest first, by passes of independent collapses (disjoint one-rings).
+   * Quadrics, collapse costs, their sort and the triangle remapping run on the pool; each pass picks its collapses
+   * in cost order. Vertices on borders and attribute seams (several vertices at one position) never move, so levels
+   * have no cracks, and collapses flipping a triangle are rejected: meshes without shared vertices (not welded) barely
+   * simplify. Stops early when no collapse is left.
+   * @param[in] mesh Triangle mesh
+   * @param[in] targetTriangles Triangle count to reach
+   * @param[in] pool Worker threads
+   * @param[in] base Optional chunk (a welded mesh or a previous level) simplified instead of the mesh faces
+   * @return Simplified mesh: source vertex of each kept vertex, in first use order, and remapped triangles
+   **/
+  MeshChunk simplifyMesh(const aiMesh* mesh, size_t targetTriangles, ThreadPool& pool, const MeshChunk* base = nullptr);
+
+  /**
+   * Weld the vertices of a triangle mesh whose streams are all byte-identical, drop the triangles that become
+   * degenerate (two corners on the same vertex or position) and the vertices no triangle references.
+   * Vertices are hashed in parallel, partitioned on their hash and deduplicated per partition in open addressing
+   * tables; compaction uses per-range prefix sums. Welded vertices keep the order of their first occurrence.
+   * @param[in] mesh Triangle mesh with faces
+   * @param[in] streams Per-vertex arrays compared by the weld (memory, element size), typically every uploaded attribute
+   * @param[in] pool Worker threads
+   * @return Welded mesh: source vertex of each welded vertex and remapped triangles
+   **/
+  MeshChunk weldMesh(const aiMesh* mesh, const std::vector<std::pair<const void*, size_t>>& streams, ThreadPool& pool);
+
+  /**
+   * Angle-weighted smooth normals of a triangle mesh (each face normal weighted by its corner angle), summed
+   * per vertex in face order on the pool, so the result does not depend on the number of threads.
+   * Distinct vertices at the same position (seams, per-face vertices) also sum the normals of each other that
+   * are within creaseAngle of their own. Vertices are never split: the faces sharing a vertex index are always
+   * smoothed together whatever their angle, so creaseAngle has no effect on a welded mesh.
+   * @param[in] mesh Triangle mesh
+   * @param[in] creaseAngle Largest angle in degrees between the normals merged across distinct vertices at the
+   * same position, 180 or more merges all of them
+   * @param[in] pool Worker threads
+   * @param[out] normals mNumVertices unit normals, (0, 0, 1) for vertices of degenerate or no triangles
+   **/
+  void generateSmoothNormals(const aiMesh* mesh, float creaseAngle, ThreadPool& pool, aiVector3D* normals);
+
+  /**
+   * MikkTSpace-compatible tangents of a triangle mesh with normals and uvs: per corner, the uv-gradient tangent of the
+   * face projected on the vertex normal plane, weighted by the corner angle in that plane, with the handedness of the
+   * uv mapping in w (bitangent = w * cross(normal, tangent)). Unlike MikkTSpace no vertex is split: a vertex whose
+   * corners have mirrored uv frames gets the handedness of the larger angle. Faces are accumulated in parallel ranges.
+   * @param[in] mesh Triangle mesh
+   * @param[in] normals mNumVertices unit normals
+   * @param[in] uvs mNumVertices texture coordinates of the normal map
+   * @param[in] pool Worker threads
+   * @param[out] tangents mNumVertices FLOAT32_VEC4 tangents
+   **/
+  void generateTangents(const aiMesh* mesh, const aiVector3D* normals, const aiVector3D* uvs, ThreadPool& pool, float* tangents);
+
+  /**
+   * Bake placed triangle meshes into one world space mesh: positions are transformed, normals by the inverse
+   * transpose of the transform, tangents and bitangents by its linear part (directions renormalized), the first
+   * color set and the uv sets are copied. Vertices and triangles are appended in part order, parts are copied in
+   * parallel.
+   * @param[in] parts Triangle meshes with faces, all with the attribute arrays of the first one
+   * @param[in] pool Worker threads
+   * @return Merged mesh, its arrays allocated with new[] as Assimp does (freed by ~aiMesh), with the material of the first part
+   **/
+  std::unique_ptr<aiMesh> mergePlacedMeshes(const std::vector<PlacedMesh>& parts, ThreadPool& pool);
+
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace {
+  // set while a thread executes pool work, nested parallelFor() calls then run inline
+  thread_local bool insidePool = false;
+}
+
+assimp_anari_bridge::ThreadPool::ThreadPool(unsigned int threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  workers.reserve(threadCount - 1);
+  for (unsigned int index = 1; index < threadCount; ++index) {
+    workers.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+assimp_anari_bridge::ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeWorkers.notify_all();
+  for (auto& worker: workers) {
+    worker.join();
+  }
+}
+
+void assimp_anari_bridge::ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+  if (workers.empty() || count == 1 || insidePool) {
+    for (size_t index = 0; index < count; ++index) {
+      task(index);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &task;
+    jobCount = count;
+    nextItem = 0;
+    error = nullptr;
+    ++generation;
+  }
+  wakeWorkers.notify_all();
+
+  insidePool = true;
+  runItems();
+  insidePool = false;
+
+  std::exception_ptr jobError;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this]() { return activeWorkers == 0; });
+    job = nullptr;
+    jobError = error;
+    error = nullptr;
+  }
+  if (jobError) {
+    std::rethrow_exception(jobError);
+  }
+}
+
+void assimp_anari_bridge::ThreadPool::parallelForRange(size_t count, size_t grain, const std::function<void(size_t, size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+  if (grain == 0) {
+    grain = (count + size() - 1) / size();
+  }
+  const size_t ranges = (count + grain - 1) / grain;
+  parallelFor(ranges, [&](size_t range) {
+    const size_t begin = range * grain;
+    task(begin, std::min(count, begin + grain));
+  });
+}
+
+void assimp_anari_bridge::ThreadPool::workerLoop() {
+  insidePool = true;
+  unsigned long long seenGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wakeWorkers.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+      if (stopping) {
+        return;
+      }
+      seenGeneration = generation;
+      if (job == nullptr) {
+        continue;
+      }
+      ++activeWorkers;
+    }
+
+    runItems();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      --activeWorkers;
+    }
+    jobDone.notify_one();
+  }
+}
+
+void assimp_anari_bridge::ThreadPool::runItems() {
+  const std::function<void(size_t)>& task = *job;
+  const size_t count = jobCount;
+  for (size_t index = nextItem.fetch_add(1); index < count; index = nextItem.fetch_add(1)) {
+    try {
+      task(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      nextItem = count;
+    }
+  }
+}
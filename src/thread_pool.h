@@ -0,0 +1,74 @@
+#ifndef _ASSIMP_ANARI_BRIDGE_THREAD_POOL_H_DEFINED
+#define _ASSIMP_ANARI_BRIDGE_THREAD_POOL_H_DEFINED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace assimp_anari_bridge {
+
+  /**
+   * Fixed size pool of worker threads used for the CPU-side conversion work.
+   * Only ever runs one parallelFor() at a time; the calling thread takes part
+   * in the work, so a pool of size 1 runs everything inline.
+   **/
+  class ThreadPool {
+  public:
+    /**
+     * @param[in] threadCount Number of threads including the caller, 0 means hardware concurrency
+     **/
+    explicit ThreadPool(unsigned int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @return Number of threads taking part in a parallelFor(), caller included
+     **/
+    unsigned int size() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+    /**
+     * Call task(i) for every i in [0, count) and wait for completion.
+     * Nested calls from inside a task run inline on the calling worker.
+     * The first exception thrown by a task is rethrown on the caller.
+     * @param[in] count Number of work items
+     * @param[in] task Work item callback
+     **/
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * Split [0, count) in ranges of at most grain items and call task(begin, end) for each.
+     * @param[in] count Number of elements
+     * @param[in] grain Maximum number of elements per range (0 picks one range per thread)
+     * @param[in] task Range callback
+     **/
+    void parallelForRange(size_t count, size_t grain, const std::function<void(size_t, size_t)>& task);
+
+  private:
+    void workerLoop();
+    void runItems();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable jobDone;
+
+    // current job, guarded by mutex except for the atomics
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobCount = 0;
+    std::atomic<size_t> nextItem{0};
+    size_t activeWorkers = 0;
+    unsigned long long generation = 0;
+    std::exception_ptr error;
+    bool stopping = false;
+  };
+
+}
+
+#endif
@@ -6,7 +6,10 @@
 #include <anari/anari.h>
 #include <anari/anari_cpp.hpp>
 // std includes
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 
 // bridge includes
 #include "../include/bridge.h"
@@ -38,11 +41,22 @@ static void statusFunc(const void *userData,
 
 int main(int argc, char** argv) {
   if (argc < 2) {
-    std::cerr << "Usage: ./test_bridge <model_path>" << std::endl;
+    std::cerr << "Usage: ./test_bridge <model_path> [thread_count]" << std::endl;
     return 1;
   }
 
   const char* modelPath = argv[1];
+  assimp_anari_bridge::BridgeOptions options;
+  if (argc > 2) {
+    options.threadCount = static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10));
+  }
+  // normal-mapping tangents and welding are done by the bridge, in parallel, rather than by
+  // aiProcess_CalcTangentSpace. Normals stay with aiProcess_GenSmoothNormals: generateNormals does
+  // not split the vertices joined by aiProcess_JoinIdenticalVertices across hard edges.
+  options.generateTangents = true;
+  options.weldVertices = true;
+  // texture files are next to the model
+  options.textureDirectory = std::filesystem::path(modelPath).parent_path().string();
   bool verbose = false;
   anari::Library library = anariLoadLibrary("helide", statusFunc, &verbose);
 
@@ -79,8 +93,11 @@ int main(int argc, char** argv) {
        return 1;
   }
 
+  // The bridge shares the scene with the device so vertex data is not copied
+  std::shared_ptr<const aiScene> sharedScene(importer.GetOrphanedScene());
+
   std::cerr << "Run AssimpXAnari bridge" << std::endl;
-  ANARIWorld world = assimp_anari_bridge::bridge(scene, device);
+  ANARIWorld world = assimp_anari_bridge::bridge(sharedScene, device, options);
   if (!world) {
     std::cerr << "Failed to build Anari world" << std::endl;
     return 1;
@@ -0,0 +1,842 @@
+// Unit tests of the CPU conversion kernels, no ANARI device needed. Built with and without BRIDGE_NATIVE_SIMD,
+// the SIMD paths are checked against the scalar references below on sizes leaving odd tails.
+
+// assimp includes
+#include <assimp/mesh.h>
+// std includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+// bridge includes
+#include "mesh_kernels.h"
+#include "mesh_processing.h"
+#include "thread_pool.h"
+
+using namespace assimp_anari_bridge;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what, size_t size) {
+  if (!condition) {
+    std::cerr << "FAILED " << what << " (size " << size << ")" << std::endl;
+    ++failures;
+  }
+}
+
+// Sizes around the 4, 8 and 16 element SIMD blocks
+static const size_t testSizes[] = { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 33, 100, 257 };
+
+// Triangle faces with their index blocks allocated one by one, or in one block when contiguous
+static void setFaces(aiMesh& mesh, const std::vector<uint32_t>& indices, std::vector<uint32_t>* block) {
+  mesh.mNumFaces = unsigned(indices.size() / 3);
+  mesh.mFaces = new aiFace[mesh.mNumFaces];
+  for (unsigned int face = 0; face < mesh.mNumFaces; ++face) {
+    mesh.mFaces[face].mNumIndices = 3;
+    mesh.mFaces[face].mIndices = block ? block->data() + 3 * face : new unsigned int[3];
+    std::memcpy(mesh.mFaces[face].mIndices, indices.data() + 3 * face, 3 * sizeof(uint32_t));
+  }
+  mesh.mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+}
+
+// Faces pointing into a caller owned block must not be freed by the aiMesh
+static void releaseFaceBlock(aiMesh& mesh) {
+  for (unsigned int face = 0; face < mesh.mNumFaces; ++face) {
+    mesh.mFaces[face].mIndices = nullptr;
+  }
+}
+
+static void testFlattenTriangles(std::mt19937& random) {
+  for (size_t size: testSizes) {
+    std::vector<uint32_t> indices(3 * size);
+    for (uint32_t& index: indices) {
+      index = random();
+    }
+    for (bool contiguous: { false, true }) {
+      std::vector<uint32_t> block(indices.size());
+      aiMesh mesh;
+      setFaces(mesh, indices, contiguous ? &block : nullptr);
+      check(trianglesAreContiguous(mesh.mFaces, 0, size) == (contiguous || size <= 1), "trianglesAreContiguous", size);
+      // odd sub-ranges too, destination indexed like the faces
+      for (size_t begin: { size_t(0), std::min<size_t>(size, 1), size / 3 }) {
+        std::vector<uint32_t> flattened(indices.size(), 0), scalar(indices.size(), 0), prefetch(indices.size(), 0);
+        flattenTriangles(mesh.mFaces, flattened.data(), begin, size);
+        flattenTrianglesScalar(mesh.mFaces, scalar.data(), begin, size);
+        flattenTrianglesPrefetch(mesh.mFaces, prefetch.data(), begin, size);
+        check(std::equal(indices.begin() + 3 * begin, indices.end(), scalar.begin() + 3 * begin), "flattenTrianglesScalar", size);
+        check(flattened == scalar, "flattenTriangles", size);
+        check(prefetch == scalar, "flattenTrianglesPrefetch", size);
+#if BRIDGE_HAS_GATHER_KERNEL
+        std::vector<uint32_t> gather(indices.size(), 0);
+        flattenTrianglesGather(mesh.mFaces, gather.data(), begin, size);
+        check(gather == scalar, "flattenTrianglesGather", size);
+#endif
+      }
+      if (contiguous) {
+        releaseFaceBlock(mesh);
+      }
+    }
+  }
+}
+
+// Grid of size x size quads, two triangles each, with shared vertices and a bumpy height
+static void makeGrid(aiMesh& mesh, unsigned int size) {
+  mesh.mNumVertices = (size + 1) * (size + 1);
+  mesh.mVertices = new aiVector3D[mesh.mNumVertices];
+  for (unsigned int y = 0; y <= size; ++y) {
+    for (unsigned int x = 0; x <= size; ++x) {
+      mesh.mVertices[y * (size + 1) + x] = aiVector3D(float(x), float(y), 0.05f * std::sin(float(x * 7 + y * 3)));
+    }
+  }
+  std::vector<uint32_t> indices;
+  for (unsigned int y = 0; y < size; ++y) {
+    for (unsigned int x = 0; x < size; ++x) {
+      const uint32_t corner = y * (size + 1) + x;
+      const uint32_t quad[6] = { corner, corner + 1, corner + size + 2, corner, corner + size + 2, corner + size + 1 };
+      indices.insert(indices.end(), quad, quad + 6);
+    }
+  }
+  setFaces(mesh, indices, nullptr);
+}
+
+// Sorted source vertex triple of every triangle of chunks, to compare triangle sets regardless of order
+static std::multiset<std::array<uint32_t, 3>> chunkTriangles(const std::vector<MeshChunk>& chunks, size_t numVertices, bool& valid) {
+  std::multiset<std::array<uint32_t, 3>> triangles;
+  for (const MeshChunk& chunk: chunks) {
+    for (size_t corner = 0; corner < chunk.indices.size(); corner += 3) {
+      std::array<uint32_t, 3> triangle;
+      for (unsigned int k = 0; k < 3; ++k) {
+        valid = valid && chunk.indices[corner + k] < chunk.vertices.size() && chunk.vertices[chunk.indices[corner + k]] < numVertices;
+        triangle[k] = valid ? chunk.vertices[chunk.indices[corner + k]] : 0;
+      }
+      std::sort(triangle.begin(), triangle.end());
+      triangles.insert(triangle);
+    }
+  }
+  return triangles;
+}
+
+static std::multiset<std::array<uint32_t, 3>> meshTriangles(const aiMesh& mesh) {
+  std::multiset<std::array<uint32_t, 3>> triangles;
+  for (unsigned int face = 0; face < mesh.mNumFaces; ++face) {
+    std::array<uint32_t, 3> triangle = { mesh.mFaces[face].mIndices[0], mesh.mFaces[face].mIndices[1], mesh.mFaces[face].mIndices[2] };
+    std::sort(triangle.begin(), triangle.end());
+    triangles.insert(triangle);
+  }
+  return triangles;
+}
+
+static void testSplitMesh(ThreadPool& pool) {
+  aiMesh mesh;
+  makeGrid(mesh, 23);
+  const std::multiset<std::array<uint32_t, 3>> original = meshTriangles(mesh);
+  for (uint64_t maxVertices: { uint64_t(3), uint64_t(17), uint64_t(100), std::numeric_limits<uint64_t>::max() }) {
+    const std::vector<MeshChunk> chunks = splitMesh(&mesh, maxVertices, pool);
+    bool valid = true, withinBudget = true;
+    for (const MeshChunk& chunk: chunks) {
+      withinBudget = withinBudget && chunk.vertices.size() <= maxVertices;
+    }
+    check(chunkTriangles(chunks, mesh.mNumVertices, valid) == original && valid, "splitMesh covers every face once", size_t(maxVertices));
+    check(withinBudget, "splitMesh vertex budget", size_t(maxVertices));
+  }
+}
+
+static void testHashBytes(std::mt19937& random) {
+  for (size_t size: testSizes) {
+    std::vector<unsigned char> bytes(size + 1);
+    for (unsigned char& byte: bytes) {
+      byte = static_cast<unsigned char>(random());
+    }
+    // same bytes at another alignment, and chained over two ranges
+    std::vector<unsigned char> shifted(size + 8);
+    std::memcpy(shifted.data() + 3, bytes.data(), size);
+    const uint64_t hash = hashBytes(bytes.data(), size, 7);
+    check(hash == hashBytes(shifted.data() + 3, size, 7), "hashBytes alignment", size);
+    check(hashBytes(bytes.data() + size / 2, size - size / 2, hashBytes(bytes.data(), size / 2, 7)) ==
+          hashBytes(bytes.data() + size / 2, size - size / 2, hashBytes(shifted.data() + 3, size / 2, 7)), "hashBytes chaining", size);
+    check(hash != hashBytes(bytes.data(), size, 8), "hashBytes seed", size);
+    if (size > 0) {
+      bytes[size - 1] ^= 1;
+      check(hash != hashBytes(bytes.data(), size, 7), "hashBytes last byte", size);
+      bytes[size - 1] ^= 1;
+      bytes[0] ^= 0x80;
+      check(hash != hashBytes(bytes.data(), size, 7), "hashBytes first byte", size);
+    }
+  }
+
+  // dedup equality: same content hash and same content for a copy, different content once a vertex moves
+  aiMesh mesh, copy;
+  makeGrid(mesh, 5);
+  makeGrid(copy, 5);
+  check(meshContentHash(&mesh) == meshContentHash(&copy), "meshContentHash copy", mesh.mNumVertices);
+  check(meshesHaveSameContent(&mesh, &copy), "meshesHaveSameContent copy", mesh.mNumVertices);
+  copy.mVertices[mesh.mNumVertices / 2].z += 1.0f;
+  check(meshContentHash(&mesh) != meshContentHash(&copy), "meshContentHash moved vertex", mesh.mNumVertices);
+  check(!meshesHaveSameContent(&mesh, &copy), "meshesHaveSameContent moved vertex", mesh.mNumVertices);
+
+  // the same uvs in channel 0 and in channel 1 are uploaded to different attributes
+  aiMesh first, second;
+  makeGrid(first, 5);
+  makeGrid(second, 5);
+  first.mTextureCoords[0] = new aiVector3D[first.mNumVertices];
+  second.mTextureCoords[1] = new aiVector3D[second.mNumVertices];
+  for (unsigned int vertex = 0; vertex < first.mNumVertices; ++vertex) {
+    first.mTextureCoords[0][vertex] = second.mTextureCoords[1][vertex] = aiVector3D(first.mVertices[vertex].x, first.mVertices[vertex].y, 0.0f);
+  }
+  check(meshContentHash(&first) != meshContentHash(&second), "meshContentHash uv channel", first.mNumVertices);
+  check(!meshesHaveSameContent(&first, &second), "meshesHaveSameContent uv channel", first.mNumVertices);
+}
+
+// Triangle indices of a mesh, 3 per face
+static std::vector<uint32_t> faceIndices(const aiMesh& mesh) {
+  std::vector<uint32_t> indices(3 * size_t(mesh.mNumFaces));
+  for (unsigned int face = 0; face < mesh.mNumFaces; ++face) {
+    std::memcpy(indices.data() + 3 * face, mesh.mFaces[face].mIndices, 3 * sizeof(uint32_t));
+  }
+  return indices;
+}
+
+static void testSimilarityTransform(std::mt19937& random) {
+  std::uniform_real_distribution<float> values(-1.0f, 1.0f);
+  aiMesh reference;
+  makeGrid(reference, 6);
+  reference.mNormals = new aiVector3D[reference.mNumVertices];
+  for (unsigned int vertex = 0; vertex < reference.mNumVertices; ++vertex) {
+    const aiVector3D normal(values(random), values(random), 1.0f);
+    reference.mNormals[vertex] = normal / normal.Length();
+  }
+
+  // 0.7 radians around (1, 2, 3), scaled by 2.5, then translated
+  const float angle = 0.7f, scale = 2.5f;
+  const aiVector3D axis = aiVector3D(1.0f, 2.0f, 3.0f) / aiVector3D(1.0f, 2.0f, 3.0f).Length();
+  const float c = std::cos(angle), s = std::sin(angle), t = 1.0f - c;
+  const float rotation[3][3] = {
+    { t * axis.x * axis.x + c, t * axis.x * axis.y - s * axis.z, t * axis.x * axis.z + s * axis.y },
+    { t * axis.x * axis.y + s * axis.z, t * axis.y * axis.y + c, t * axis.y * axis.z - s * axis.x },
+    { t * axis.x * axis.z - s * axis.y, t * axis.y * axis.z + s * axis.x, t * axis.z * axis.z + c }
+  };
+  const float translation[3] = { 10.0f, -4.0f, 3.0f };
+  for (bool mirrored: { false, true }) {
+    // the mirrored copy flips x first: no rotation maps the reference onto it
+    aiMesh copy;
+    copy.mNumVertices = reference.mNumVertices;
+    copy.mVertices = new aiVector3D[copy.mNumVertices];
+    copy.mNormals = new aiVector3D[copy.mNumVertices];
+    for (unsigned int vertex = 0; vertex < copy.mNumVertices; ++vertex) {
+      aiVector3D position = reference.mVertices[vertex], normal = reference.mNormals[vertex];
+      if (mirrored) {
+        position.x = -position.x;
+        normal.x = -normal.x;
+      }
+      for (unsigned int row = 0; row < 3; ++row) {
+        copy.mVertices[vertex][row] = scale * (rotation[row][0] * position.x + rotation[row][1] * position.y + rotation[row][2] * position.z) + translation[row];
+        copy.mNormals[vertex][row] = rotation[row][0] * normal.x + rotation[row][1] * normal.y + rotation[row][2] * normal.z;
+      }
+    }
+    setFaces(copy, faceIndices(reference), nullptr);
+
+    aiMatrix4x4 transform;
+    const bool found = findSimilarityTransform(&reference, &copy, 1e-4f, transform);
+    check(found != mirrored, mirrored ? "findSimilarityTransform rejects a mirror" : "findSimilarityTransform finds the copy", copy.mNumVertices);
+    if (found) {
+      float largest = 0.0f;
+      for (unsigned int vertex = 0; vertex < copy.mNumVertices; ++vertex) {
+        largest = std::max(largest, (transform * reference.mVertices[vertex] - copy.mVertices[vertex]).Length());
+      }
+      check(largest < 1e-3f, "findSimilarityTransform maps the reference onto the copy", copy.mNumVertices);
+    }
+    if (!mirrored) {
+      // a vertex moved off the transform
+      copy.mVertices[copy.mNumVertices / 3].z += 0.1f;
+      check(!findSimilarityTransform(&reference, &copy, 1e-4f, transform), "findSimilarityTransform rejects a moved vertex", copy.mNumVertices);
+    }
+  }
+}
+
+static void testMortonOrder(std::mt19937& random, ThreadPool& pool) {
+  check(mortonCode(1, 0, 0) == 1 && mortonCode(0, 1, 0) == 2 && mortonCode(0, 0, 1) == 4, "mortonCode axes", 1);
+  check(mortonCode(0x1fffff, 0, 0) == 0x1249249249249249ull && mortonCode(0x1fffff, 0x1fffff, 0x1fffff) == 0x7fffffffffffffffull,
+        "mortonCode 21 bits", 21);
+
+  // grid with its triangles shuffled
+  aiMesh grid;
+  makeGrid(grid, 15);
+  const std::vector<uint32_t> gridIndices = faceIndices(grid);
+  std::vector<uint32_t> shuffled(grid.mNumFaces);
+  for (uint32_t face = 0; face < grid.mNumFaces; ++face) {
+    shuffled[face] = face;
+  }
+  std::shuffle(shuffled.begin(), shuffled.end(), random);
+  std::vector<uint32_t> indices;
+  for (uint32_t face: shuffled) {
+    indices.insert(indices.end(), gridIndices.begin() + 3 * face, gridIndices.begin() + 3 * face + 3);
+  }
+  aiMesh mesh;
+  mesh.mNumVertices = grid.mNumVertices;
+  mesh.mVertices = new aiVector3D[mesh.mNumVertices];
+  std::copy(grid.mVertices, grid.mVertices + grid.mNumVertices, mesh.mVertices);
+  setFaces(mesh, indices, nullptr);
+
+  ThreadPool serial(1);
+  const std::vector<uint32_t> order = mortonOrderTriangles(&mesh, pool);
+  check(order == mortonOrderTriangles(&mesh, serial), "mortonOrderTriangles thread count", order.size());
+  std::vector<uint32_t> sorted(order);
+  std::sort(sorted.begin(), sorted.end());
+  bool permutation = sorted.size() == mesh.mNumFaces;
+  for (uint32_t face = 0; permutation && face < mesh.mNumFaces; ++face) {
+    permutation = sorted[face] == face;
+  }
+  check(permutation, "mortonOrderTriangles permutation", order.size());
+
+  // consecutive triangles along the curve are much closer than in the shuffled order
+  auto centroid = [&](uint32_t face) {
+    const unsigned int* corner = mesh.mFaces[face].mIndices;
+    return (mesh.mVertices[corner[0]] + mesh.mVertices[corner[1]] + mesh.mVertices[corner[2]]) / 3.0f;
+  };
+  float curvePath = 0.0f, shuffledPath = 0.0f;
+  for (uint32_t face = 1; permutation && face < mesh.mNumFaces; ++face) {
+    curvePath += (centroid(order[face]) - centroid(order[face - 1])).Length();
+    shuffledPath += (centroid(face) - centroid(face - 1)).Length();
+  }
+  check(curvePath < 0.5f * shuffledPath, "mortonOrderTriangles locality", order.size());
+
+  // no vertex budget: one chunk with the triangles along the curve and the vertices in first use order
+  const std::vector<MeshChunk> chunks = splitMesh(&mesh, std::numeric_limits<uint64_t>::max(), pool);
+  check(chunks.size() == 1, "splitMesh without budget is one chunk", chunks.size());
+  if (chunks.size() == 1 && permutation) {
+    const MeshChunk& chunk = chunks.front();
+    bool alongCurve = chunk.indices.size() == 3 * order.size(), firstUse = true;
+    uint32_t next = 0;
+    for (size_t corner = 0; alongCurve && corner < chunk.indices.size(); ++corner) {
+      const uint32_t vertex = chunk.indices[corner];
+      firstUse = firstUse && vertex <= next;
+      next += vertex == next ? 1 : 0;
+      alongCurve = vertex < chunk.vertices.size() && chunk.vertices[vertex] == mesh.mFaces[order[corner / 3]].mIndices[corner % 3];
+    }
+    check(alongCurve, "splitMesh without budget follows the curve", chunk.indices.size() / 3);
+    check(firstUse && next == chunk.vertices.size(), "splitMesh without budget numbers vertices in first use order", chunk.vertices.size());
+  }
+}
+
+template <typename T>
+static void testQuantizeFormat(std::mt19937& random, NormalizedFormat format, float lower, float scale) {
+  std::uniform_real_distribution<float> values(lower - 0.25f, 1.25f);
+  for (size_t size: testSizes) {
+    std::vector<float> source(size);
+    for (float& value: source) {
+      value = values(random);
+    }
+    if (size >= 3) {
+      // exact bounds, and out of range values that must clamp
+      source[0] = 1.0f;
+      source[1] = lower;
+      source[2] = 2.0f;
+    }
+    std::vector<T> quantized(size);
+    const float reported = quantizeNormalized(source.data(), quantized.data(), size, format);
+    float largest = 0.0f;
+    bool matches = true, rounded = true;
+    for (size_t index = 0; index < size; ++index) {
+      const float clamped = std::min(1.0f, std::max(lower, source[index]));
+      const float expected = std::nearbyint(clamped * scale);
+      matches = matches && quantized[index] == static_cast<T>(expected);
+      // nearest code of the clamped value
+      rounded = rounded && std::fabs(float(quantized[index]) - clamped * scale) <= 0.5f + 1e-3f;
+      largest = std::max(largest, std::fabs(float(quantized[index]) / scale - source[index]));
+    }
+    check(matches, "quantizeNormalized scalar reference", size);
+    check(rounded, "quantizeNormalized rounding", size);
+    check(largest <= reported, "quantizeNormalized error <= reported", size);
+    check(reported <= largest, "quantizeNormalized reported error is reached", size);
+    if (size >= 3) {
+      check(quantized[0] == static_cast<T>(scale) && quantized[2] == static_cast<T>(scale), "quantizeNormalized upper clamp", size);
+      check(quantized[1] == static_cast<T>(lower * scale), "quantizeNormalized lower clamp", size);
+      check(reported >= 1.0f, "quantizeNormalized clamp error reported", size);
+    }
+  }
+}
+
+static void testQuantizeNormalized(std::mt19937& random) {
+  testQuantizeFormat<int8_t>(random, NormalizedFormat::SNORM8, -1.0f, 127.0f);
+  testQuantizeFormat<int16_t>(random, NormalizedFormat::SNORM16, -1.0f, 32767.0f);
+  testQuantizeFormat<uint8_t>(random, NormalizedFormat::UNORM8, 0.0f, 255.0f);
+  testQuantizeFormat<uint16_t>(random, NormalizedFormat::UNORM16, 0.0f, 65535.0f);
+}
+
+static void testPackTangents(std::mt19937& random) {
+  std::uniform_real_distribution<float> values(-1.0f, 1.0f);
+  for (size_t size: testSizes) {
+    std::vector<aiVector3D> normals(size), tangents(size), bitangents(size);
+    std::vector<uint32_t> vertices(size);
+    for (size_t index = 0; index < size; ++index) {
+      normals[index] = aiVector3D(values(random), values(random), values(random));
+      tangents[index] = aiVector3D(values(random), values(random), values(random));
+      bitangents[index] = aiVector3D(values(random), values(random), values(random));
+      vertices[index] = uint32_t(random() % size);
+    }
+    for (bool gathered: { false, true }) {
+      const size_t begin = size / 3;
+      std::vector<float> packed(4 * (size - begin));
+      packTangents(normals.data(), tangents.data(), bitangents.data(), size, gathered ? vertices.data() : nullptr, packed.data(), begin, size);
+      bool copied = true, signs = true;
+      for (size_t index = begin; index < size; ++index) {
+        const size_t source = gathered ? vertices[index] : index;
+        const float* tangent = packed.data() + 4 * (index - begin);
+        const aiVector3D& n = normals[source];
+        const aiVector3D& t = tangents[source];
+        const aiVector3D& b = bitangents[source];
+        copied = copied && tangent[0] == t.x && tangent[1] == t.y && tangent[2] == t.z;
+        // w = +1 for a right-handed (normal, tangent, bitangent) frame
+        const float dot = (n.y * t.z - n.z * t.y) * b.x + (n.z * t.x - n.x * t.z) * b.y + (n.x * t.y - n.y * t.x) * b.z;
+        signs = signs && tangent[3] == (dot < 0.0f ? -1.0f : 1.0f);
+      }
+      check(copied, gathered ? "packTangents gathered xyz" : "packTangents xyz", size);
+      check(signs, gathered ? "packTangents gathered sign" : "packTangents sign", size);
+    }
+  }
+}
+
+// Cube of side 2 with its own 4 vertices per face (24 vertices), triangles wound outwards
+static void makeCube(aiMesh& mesh) {
+  mesh.mNumVertices = 24;
+  mesh.mVertices = new aiVector3D[mesh.mNumVertices];
+  const float corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+  std::vector<uint32_t> indices;
+  for (unsigned int face = 0; face < 6; ++face) {
+    // (u, v, axis) is right-handed: counter-clockwise in (u, v) faces +axis
+    const unsigned int axis = face / 2, u = (axis + 1) % 3, v = (axis + 2) % 3;
+    const float side = face % 2 ? 1.0f : -1.0f;
+    const uint32_t first = 4 * face;
+    for (unsigned int k = 0; k < 4; ++k) {
+      aiVector3D& position = mesh.mVertices[first + k];
+      position[axis] = side;
+      position[u] = corners[k][0];
+      position[v] = corners[k][1];
+    }
+    const uint32_t outwards[6] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+    const uint32_t inwards[6] = { first, first + 2, first + 1, first, first + 3, first + 2 };
+    indices.insert(indices.end(), side > 0.0f ? outwards : inwards, (side > 0.0f ? outwards : inwards) + 6);
+  }
+  setFaces(mesh, indices, nullptr);
+}
+
+static void testSmoothNormals(ThreadPool& pool) {
+  // flat grid: the plane normal everywhere
+  aiMesh grid;
+  makeGrid(grid, 9);
+  for (unsigned int vertex = 0; vertex < grid.mNumVertices; ++vertex) {
+    grid.mVertices[vertex].z = 0.0f;
+  }
+  std::vector<aiVector3D> normals(grid.mNumVertices);
+  generateSmoothNormals(&grid, 175.0f, pool, normals.data());
+  bool flat = true;
+  for (const aiVector3D& normal: normals) {
+    flat = flat && (normal - aiVector3D(0.0f, 0.0f, 1.0f)).Length() < 1e-6f;
+  }
+  check(flat, "generateSmoothNormals flat grid", normals.size());
+
+  // bumpy grid: unit normals facing up
+  aiMesh bumpy;
+  makeGrid(bumpy, 9);
+  generateSmoothNormals(&bumpy, 175.0f, pool, normals.data());
+  bool unit = true;
+  for (const aiVector3D& normal: normals) {
+    unit = unit && std::fabs(normal.Length() - 1.0f) < 1e-5f && normal.z > 0.9f;
+  }
+  check(unit, "generateSmoothNormals unit normals", normals.size());
+
+  // cube with per-face vertices: 90 degree edges stay hard below the crease angle, corners are averaged above it
+  aiMesh cube;
+  makeCube(cube);
+  std::vector<aiVector3D> hard(cube.mNumVertices), smooth(cube.mNumVertices);
+  generateSmoothNormals(&cube, 45.0f, pool, hard.data());
+  generateSmoothNormals(&cube, 180.0f, pool, smooth.data());
+  bool faceNormals = true, cornerNormals = true;
+  for (unsigned int vertex = 0; vertex < cube.mNumVertices; ++vertex) {
+    aiVector3D faceNormal(0.0f, 0.0f, 0.0f);
+    faceNormal[vertex / 8] = (vertex / 4) % 2 ? 1.0f : -1.0f;
+    faceNormals = faceNormals && (hard[vertex] - faceNormal).Length() < 1e-6f;
+    const aiVector3D& corner = cube.mVertices[vertex];
+    cornerNormals = cornerNormals && (smooth[vertex] - corner / corner.Length()).Length() < 1e-5f;
+  }
+  check(faceNormals, "generateSmoothNormals hard edges", cube.mNumVertices);
+  check(cornerNormals, "generateSmoothNormals smoothed corners", cube.mNumVertices);
+
+  // a vertex of no triangle and the vertices of a degenerate one get the fallback normal
+  aiMesh lonely;
+  lonely.mNumVertices = 7;
+  lonely.mVertices = new aiVector3D[lonely.mNumVertices];
+  lonely.mVertices[1] = aiVector3D(1.0f, 0.0f, 0.0f);
+  lonely.mVertices[2] = aiVector3D(0.0f, 1.0f, 0.0f);
+  lonely.mVertices[3] = aiVector3D(5.0f, 5.0f, 5.0f);
+  lonely.mVertices[4] = lonely.mVertices[5] = aiVector3D(7.0f, 7.0f, 7.0f);
+  lonely.mVertices[6] = aiVector3D(8.0f, 7.0f, 7.0f);
+  setFaces(lonely, { 0, 1, 2, 4, 5, 6 }, nullptr);
+  std::vector<aiVector3D> lonelyNormals(lonely.mNumVertices);
+  generateSmoothNormals(&lonely, 175.0f, pool, lonelyNormals.data());
+  bool fallback = (lonelyNormals[0] - aiVector3D(0.0f, 0.0f, 1.0f)).Length() < 1e-6f;
+  for (unsigned int vertex = 3; vertex < lonely.mNumVertices; ++vertex) {
+    fallback = fallback && lonelyNormals[vertex] == aiVector3D(0.0f, 0.0f, 1.0f);
+  }
+  check(fallback, "generateSmoothNormals fallback normal", lonely.mNumVertices);
+}
+
+static void testTangents(ThreadPool& pool) {
+  // flat grid with uvs along x and y: tangent +x, right-handed; mirrored u: tangent -x, left-handed
+  aiMesh grid;
+  makeGrid(grid, 9);
+  std::vector<aiVector3D> normals(grid.mNumVertices, aiVector3D(0.0f, 0.0f, 1.0f));
+  std::vector<aiVector3D> uvs(grid.mNumVertices), mirroredUvs(grid.mNumVertices);
+  for (unsigned int vertex = 0; vertex < grid.mNumVertices; ++vertex) {
+    grid.mVertices[vertex].z = 0.0f;
+    uvs[vertex] = aiVector3D(grid.mVertices[vertex].x / 9.0f, grid.mVertices[vertex].y / 9.0f, 0.0f);
+    mirroredUvs[vertex] = aiVector3D(1.0f - uvs[vertex].x, uvs[vertex].y, 0.0f);
+  }
+  std::vector<float> tangents(4 * size_t(grid.mNumVertices)), mirrored(tangents.size());
+  generateTangents(&grid, normals.data(), uvs.data(), pool, tangents.data());
+  generateTangents(&grid, normals.data(), mirroredUvs.data(), pool, mirrored.data());
+  bool alongU = true, mirroredU = true;
+  for (unsigned int vertex = 0; vertex < grid.mNumVertices; ++vertex) {
+    const float* tangent = tangents.data() + 4 * vertex;
+    const float* flipped = mirrored.data() + 4 * vertex;
+    alongU = alongU && std::fabs(tangent[0] - 1.0f) < 1e-5f && std::fabs(tangent[1]) < 1e-5f && std::fabs(tangent[2]) < 1e-5f && tangent[3] == 1.0f;
+    mirroredU = mirroredU && std::fabs(flipped[0] + 1.0f) < 1e-5f && std::fabs(flipped[1]) < 1e-5f && std::fabs(flipped[2]) < 1e-5f && flipped[3] == -1.0f;
+  }
+  check(alongU, "generateTangents along u", grid.mNumVertices);
+  check(mirroredU, "generateTangents mirrored u", grid.mNumVertices);
+
+  // bumpy grid with generated normals and a skewed mapping: unit tangents in the normal plane, w = +-1
+  aiMesh bumpy;
+  makeGrid(bumpy, 9);
+  generateSmoothNormals(&bumpy, 175.0f, pool, normals.data());
+  for (unsigned int vertex = 0; vertex < bumpy.mNumVertices; ++vertex) {
+    const aiVector3D& position = bumpy.mVertices[vertex];
+    uvs[vertex] = aiVector3D(0.37f * position.x + 0.11f * position.y, 0.29f * position.y - 0.05f * position.x, 0.0f);
+  }
+  generateTangents(&bumpy, normals.data(), uvs.data(), pool, tangents.data());
+  bool frames = true;
+  for (unsigned int vertex = 0; vertex < bumpy.mNumVertices; ++vertex) {
+    const float* tangent = tangents.data() + 4 * vertex;
+    const aiVector3D direction(tangent[0], tangent[1], tangent[2]);
+    frames = frames && std::fabs(direction.Length() - 1.0f) < 1e-5f && std::fabs(direction * normals[vertex]) < 1e-5f &&
+             (tangent[3] == 1.0f || tangent[3] == -1.0f);
+  }
+  check(frames, "generateTangents frames", bumpy.mNumVertices);
+}
+
+static void testWeldMesh(ThreadPool& pool) {
+  // every triangle of a grid with its own three vertices, plus one degenerate triangle
+  aiMesh grid;
+  makeGrid(grid, 6);
+  aiMesh mesh;
+  mesh.mNumVertices = 3 * grid.mNumFaces + 3;
+  mesh.mVertices = new aiVector3D[mesh.mNumVertices];
+  std::vector<uint32_t> indices;
+  for (unsigned int face = 0; face < grid.mNumFaces; ++face) {
+    for (unsigned int k = 0; k < 3; ++k) {
+      mesh.mVertices[3 * face + k] = grid.mVertices[grid.mFaces[face].mIndices[k]];
+      indices.push_back(3 * face + k);
+    }
+  }
+  mesh.mVertices[mesh.mNumVertices - 3] = mesh.mVertices[mesh.mNumVertices - 2] = mesh.mVertices[mesh.mNumVertices - 1] = aiVector3D(0.5f, 0.5f, 9.0f);
+  indices.push_back(mesh.mNumVertices - 3);
+  indices.push_back(mesh.mNumVertices - 2);
+  indices.push_back(mesh.mNumVertices - 1);
+  setFaces(mesh, indices, nullptr);
+
+  const MeshChunk welded = weldMesh(&mesh, { { mesh.mVertices, sizeof(aiVector3D) } }, pool);
+  check(welded.vertices.size() == grid.mNumVertices, "weldMesh vertex count", mesh.mNumVertices);
+  check(welded.indices.size() == 3 * size_t(grid.mNumFaces), "weldMesh drops the degenerate triangle", mesh.mNumFaces);
+  bool valid = true, samePositions = true;
+  std::vector<bool> used(welded.vertices.size(), false);
+  for (size_t corner = 0; corner < welded.indices.size(); ++corner) {
+    const uint32_t vertex = welded.indices[corner];
+    valid = valid && vertex < welded.vertices.size() && welded.vertices[vertex] < mesh.mNumVertices;
+    if (!valid) {
+      break;
+    }
+    used[vertex] = true;
+    // the remapped corner is a vertex equal to the original corner, triangles in order
+    const aiVector3D& original = mesh.mVertices[mesh.mFaces[corner / 3].mIndices[corner % 3]];
+    const aiVector3D& remapped = mesh.mVertices[welded.vertices[vertex]];
+    samePositions = samePositions && original.x == remapped.x && original.y == remapped.y && original.z == remapped.z;
+  }
+  check(valid, "weldMesh remap in range", mesh.mNumVertices);
+  check(samePositions, "weldMesh remap keeps the corners", mesh.mNumVertices);
+  check(std::find(used.begin(), used.end(), false) == used.end(), "weldMesh keeps only used vertices", mesh.mNumVertices);
+}
+
+// Grid with unit normals, tangents orthogonal to them, bitangents, colors and uv sets 0 and 2
+static void makeDressedGrid(aiMesh& mesh, unsigned int size, std::mt19937& random) {
+  std::uniform_real_distribution<float> values(-1.0f, 1.0f);
+  makeGrid(mesh, size);
+  mesh.mNormals = new aiVector3D[mesh.mNumVertices];
+  mesh.mTangents = new aiVector3D[mesh.mNumVertices];
+  mesh.mBitangents = new aiVector3D[mesh.mNumVertices];
+  mesh.mColors[0] = new aiColor4D[mesh.mNumVertices];
+  mesh.mTextureCoords[0] = new aiVector3D[mesh.mNumVertices];
+  mesh.mTextureCoords[2] = new aiVector3D[mesh.mNumVertices];
+  for (unsigned int vertex = 0; vertex < mesh.mNumVertices; ++vertex) {
+    const aiVector3D normal(values(random), values(random), 1.0f);
+    mesh.mNormals[vertex] = normal / normal.Length();
+    aiVector3D tangent(1.0f, values(random), values(random));
+    tangent -= mesh.mNormals[vertex] * (mesh.mNormals[vertex] * tangent);
+    mesh.mTangents[vertex] = tangent / tangent.Length();
+    mesh.mBitangents[vertex] = mesh.mNormals[vertex] ^ mesh.mTangents[vertex];
+    mesh.mColors[0][vertex] = aiColor4D(values(random), values(random), values(random), 1.0f);
+    mesh.mTextureCoords[0][vertex] = aiVector3D(values(random), values(random), 0.0f);
+    mesh.mTextureCoords[2][vertex] = aiVector3D(values(random), values(random), 0.0f);
+  }
+}
+
+static void testMergePlacedMeshes(std::mt19937& random, ThreadPool& pool) {
+  aiMesh first, second;
+  makeDressedGrid(first, 3, random);
+  makeDressedGrid(second, 5, random);
+  first.mMaterialIndex = 3;
+  // non-uniform scale, then a rotation around z with x mirrored (negative determinant)
+  const std::vector<PlacedMesh> parts = {
+    { &first, aiMatrix4x4(2.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.5f, 0.0f, -2.0f, 0.0f, 0.0f, 3.0f, 5.0f, 0.0f, 0.0f, 0.0f, 1.0f) },
+    { &second, aiMatrix4x4(0.0f, -1.0f, 0.0f, 7.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, -3.0f, 0.0f, 0.0f, 0.0f, 1.0f) }
+  };
+  const std::unique_ptr<aiMesh> merged = mergePlacedMeshes(parts, pool);
+  check(merged->mNumVertices == first.mNumVertices + second.mNumVertices && merged->mNumFaces == first.mNumFaces + second.mNumFaces,
+        "mergePlacedMeshes counts", merged->mNumVertices);
+  check(merged->mMaterialIndex == 3 && merged->mNormals && merged->mTangents && merged->mBitangents && merged->mColors[0] &&
+        merged->mTextureCoords[0] && !merged->mTextureCoords[1] && merged->mTextureCoords[2], "mergePlacedMeshes arrays", merged->mNumVertices);
+  if (merged->mNumVertices != first.mNumVertices + second.mNumVertices || !merged->mNormals || !merged->mTangents || !merged->mTextureCoords[2]) {
+    return;
+  }
+
+  unsigned int vertexOffset = 0, faceOffset = 0;
+  bool positions = true, directions = true, copied = true, faces = true;
+  for (const PlacedMesh& part: parts) {
+    const aiMesh* mesh = part.mesh;
+    const aiMatrix4x4& transform = part.transform;
+    // inverse transpose of the linear part: cofactors over the determinant
+    double cofactors[3][3];
+    for (unsigned int row = 0; row < 3; ++row) {
+      for (unsigned int column = 0; column < 3; ++column) {
+        const unsigned int r1 = (row + 1) % 3, r2 = (row + 2) % 3, c1 = (column + 1) % 3, c2 = (column + 2) % 3;
+        cofactors[row][column] = double(transform[r1][c1]) * transform[r2][c2] - double(transform[r1][c2]) * transform[r2][c1];
+      }
+    }
+    const double determinant = transform[0][0] * cofactors[0][0] + transform[0][1] * cofactors[0][1] + transform[0][2] * cofactors[0][2];
+    for (unsigned int vertex = 0; vertex < mesh->mNumVertices; ++vertex) {
+      const unsigned int index = vertexOffset + vertex;
+      positions = positions && (merged->mVertices[index] - transform * mesh->mVertices[vertex]).Length() < 1e-5f;
+      const aiVector3D& normal = mesh->mNormals[vertex];
+      aiVector3D expected;
+      for (unsigned int row = 0; row < 3; ++row) {
+        expected[row] = float((cofactors[row][0] * normal.x + cofactors[row][1] * normal.y + cofactors[row][2] * normal.z) / determinant);
+      }
+      expected /= expected.Length();
+      // normals stay unit and orthogonal to the tangents, which follow the linear part
+      const aiVector3D& mergedNormal = merged->mNormals[index];
+      const aiVector3D& mergedTangent = merged->mTangents[index];
+      directions = directions && mergedNormal * expected > 1.0f - 1e-5f && std::fabs(mergedNormal * mergedTangent) < 1e-5f &&
+                   std::fabs(mergedTangent.Length() - 1.0f) < 1e-5f && std::fabs(merged->mBitangents[index].Length() - 1.0f) < 1e-5f;
+    }
+    copied = copied && std::memcmp(merged->mColors[0] + vertexOffset, mesh->mColors[0], mesh->mNumVertices * sizeof(aiColor4D)) == 0 &&
+             std::memcmp(merged->mTextureCoords[0] + vertexOffset, mesh->mTextureCoords[0], mesh->mNumVertices * sizeof(aiVector3D)) == 0 &&
+             std::memcmp(merged->mTextureCoords[2] + vertexOffset, mesh->mTextureCoords[2], mesh->mNumVertices * sizeof(aiVector3D)) == 0;
+    for (unsigned int face = 0; face < mesh->mNumFaces; ++face) {
+      for (unsigned int k = 0; k < 3; ++k) {
+        faces = faces && merged->mFaces[faceOffset + face].mIndices[k] == vertexOffset + mesh->mFaces[face].mIndices[k];
+      }
+    }
+    vertexOffset += mesh->mNumVertices;
+    faceOffset += mesh->mNumFaces;
+  }
+  check(positions, "mergePlacedMeshes positions", merged->mNumVertices);
+  check(directions, "mergePlacedMeshes directions", merged->mNumVertices);
+  check(copied, "mergePlacedMeshes colors and uvs", merged->mNumVertices);
+  check(faces, "mergePlacedMeshes faces", merged->mNumFaces);
+}
+
+static void testClusterMesh(ThreadPool& pool) {
+  aiMesh mesh;
+  makeGrid(mesh, 23);
+  const std::multiset<std::array<uint32_t, 3>> original = meshTriangles(mesh);
+  for (size_t maxTriangles: { size_t(1), size_t(7), size_t(64), size_t(5000) }) {
+    const std::vector<MeshChunk> clusters = clusterMesh(&mesh, maxTriangles, pool);
+    bool valid = true, withinBudget = true;
+    for (const MeshChunk& cluster: clusters) {
+      withinBudget = withinBudget && cluster.indices.size() / 3 <= maxTriangles;
+    }
+    check(chunkTriangles(clusters, mesh.mNumVertices, valid) == original && valid, "clusterMesh covers every face once", maxTriangles);
+    check(withinBudget, "clusterMesh triangle budget", maxTriangles);
+  }
+
+  // huge coordinates: float surface areas overflow, the splits must still terminate
+  for (unsigned int vertex = 0; vertex < mesh.mNumVertices; ++vertex) {
+    mesh.mVertices[vertex] *= 1e19f;
+  }
+  const std::vector<MeshChunk> clusters = clusterMesh(&mesh, 4, pool);
+  bool valid = true;
+  check(chunkTriangles(clusters, mesh.mNumVertices, valid) == original && valid, "clusterMesh huge coordinates", mesh.mNumFaces);
+}
+
+static void testSimplifyMesh(ThreadPool& pool) {
+  aiMesh mesh;
+  makeGrid(mesh, 20);
+  const MeshChunk simplified = simplifyMesh(&mesh, mesh.mNumFaces / 4, pool);
+  const size_t triangles = simplified.indices.size() / 3;
+  check(triangles > 0 && triangles < mesh.mNumFaces, "simplifyMesh reduces", triangles);
+  bool valid = true, degenerate = false;
+  std::vector<bool> used(simplified.vertices.size(), false);
+  for (size_t corner = 0; corner < simplified.indices.size(); corner += 3) {
+    for (unsigned int k = 0; k < 3; ++k) {
+      valid = valid && simplified.indices[corner + k] < simplified.vertices.size() && simplified.vertices[simplified.indices[corner + k]] < mesh.mNumVertices;
+    }
+    if (!valid) {
+      break;
+    }
+    for (unsigned int k = 0; k < 3; ++k) {
+      used[simplified.indices[corner + k]] = true;
+    }
+    degenerate = degenerate || simplified.indices[corner] == simplified.indices[corner + 1] ||
+                 simplified.indices[corner + 1] == simplified.indices[corner + 2] || simplified.indices[corner] == simplified.indices[corner + 2];
+  }
+  check(valid, "simplifyMesh indices in range", triangles);
+  check(!degenerate, "simplifyMesh no degenerate triangle", triangles);
+  check(std::find(used.begin(), used.end(), false) == used.end(), "simplifyMesh keeps only used vertices", triangles);
+  // borders are locked: the grid corners survive
+  std::set<uint32_t> kept(simplified.vertices.begin(), simplified.vertices.end());
+  check(kept.count(0) && kept.count(20) && kept.count(mesh.mNumVertices - 1), "simplifyMesh keeps the borders", triangles);
+}
+
+// Generated attributes and levels of detail must not depend on the thread count, bit for bit
+static void testThreadCountIndependence() {
+  aiMesh mesh;
+  makeGrid(mesh, 160);
+  std::vector<aiVector3D> uvs(mesh.mNumVertices);
+  for (unsigned int vertex = 0; vertex < mesh.mNumVertices; ++vertex) {
+    const aiVector3D& position = mesh.mVertices[vertex];
+    uvs[vertex] = aiVector3D(0.37f * position.x + 0.11f * position.y, 0.29f * position.y - 0.05f * position.x, 0.0f);
+  }
+  ThreadPool serial(1), parallel(8);
+  std::vector<aiVector3D> serialNormals(mesh.mNumVertices), parallelNormals(mesh.mNumVertices);
+  generateSmoothNormals(&mesh, 175.0f, serial, serialNormals.data());
+  generateSmoothNormals(&mesh, 175.0f, parallel, parallelNormals.data());
+  check(std::memcmp(serialNormals.data(), parallelNormals.data(), mesh.mNumVertices * sizeof(aiVector3D)) == 0,
+        "generateSmoothNormals thread count", mesh.mNumVertices);
+
+  std::vector<float> serialTangents(4 * size_t(mesh.mNumVertices)), parallelTangents(serialTangents.size());
+  generateTangents(&mesh, serialNormals.data(), uvs.data(), serial, serialTangents.data());
+  generateTangents(&mesh, serialNormals.data(), uvs.data(), parallel, parallelTangents.data());
+  check(std::memcmp(serialTangents.data(), parallelTangents.data(), serialTangents.size() * sizeof(float)) == 0,
+        "generateTangents thread count", mesh.mNumVertices);
+
+  const MeshChunk serialLod = simplifyMesh(&mesh, mesh.mNumFaces / 4, serial);
+  const MeshChunk parallelLod = simplifyMesh(&mesh, mesh.mNumFaces / 4, parallel);
+  check(serialLod.vertices == parallelLod.vertices && serialLod.indices == parallelLod.indices, "simplifyMesh thread count", mesh.mNumFaces);
+}
+
+static void testGrowBounds(std::mt19937& random) {
+  std::uniform_real_distribution<float> values(-1000.0f, 1000.0f);
+  const float empty = std::numeric_limits<float>::max();
+  for (size_t size: testSizes) {
+    std::vector<aiVector3D> points(size);
+    for (aiVector3D& point: points) {
+      point = aiVector3D(values(random), values(random), values(random));
+    }
+    float lower[3] = { empty, empty, empty }, upper[3] = { -empty, -empty, -empty };
+    growBounds(points.data(), size, lower, upper);
+    float referenceLower[3] = { empty, empty, empty }, referenceUpper[3] = { -empty, -empty, -empty };
+    for (const aiVector3D& point: points) {
+      for (unsigned int axis = 0; axis < 3; ++axis) {
+        referenceLower[axis] = std::min(referenceLower[axis], point[axis]);
+        referenceUpper[axis] = std::max(referenceUpper[axis], point[axis]);
+      }
+    }
+    check(std::equal(lower, lower + 3, referenceLower) && std::equal(upper, upper + 3, referenceUpper), "growBounds", size);
+  }
+}
+
+static void testOffsetPoints(std::mt19937& random) {
+  std::uniform_real_distribution<float> values(-1000.0f, 1000.0f);
+  const float origin[3] = { 10.5f, -3.25f, 1000.0f };
+  const float empty = std::numeric_limits<float>::max();
+  for (size_t size: testSizes) {
+    std::vector<aiVector3D> points(size);
+    std::vector<uint32_t> vertices(size);
+    for (size_t index = 0; index < size; ++index) {
+      points[index] = aiVector3D(values(random), values(random), values(random));
+      vertices[index] = uint32_t(random() % size);
+    }
+    // points and their bounds against the scalar reference, in order and gathered
+    for (bool gathered: { false, true }) {
+      const size_t begin = size / 3;
+      std::vector<float> offset(3 * (size - begin));
+      float lower[3] = { empty, empty, empty }, upper[3] = { -empty, -empty, -empty };
+      offsetPoints(points.data(), gathered ? vertices.data() : nullptr, origin, offset.data(), begin, size, lower, upper);
+      float referenceLower[3] = { empty, empty, empty }, referenceUpper[3] = { -empty, -empty, -empty };
+      bool matches = true;
+      for (size_t index = begin; index < size; ++index) {
+        const aiVector3D& point = points[gathered ? vertices[index] : index];
+        for (unsigned int axis = 0; axis < 3; ++axis) {
+          const float expected = point[axis] - origin[axis];
+          matches = matches && offset[3 * (index - begin) + axis] == expected;
+          referenceLower[axis] = std::min(referenceLower[axis], expected);
+          referenceUpper[axis] = std::max(referenceUpper[axis], expected);
+        }
+      }
+      check(matches, gathered ? "offsetPoints gathered" : "offsetPoints", size);
+      check(std::equal(lower, lower + 3, referenceLower) && std::equal(upper, upper + 3, referenceUpper),
+            gathered ? "offsetPoints gathered bounds" : "offsetPoints bounds", size);
+    }
+  }
+}
+
+static void testExtractChannel(std::mt19937& random) {
+  for (size_t size: testSizes) {
+    for (unsigned int channels = 1; channels <= 4; ++channels) {
+      std::vector<uint8_t> pixels(size * channels);
+      for (uint8_t& byte: pixels) {
+        byte = static_cast<uint8_t>(random());
+      }
+      for (unsigned int channel = 0; channel < channels; ++channel) {
+        std::vector<uint8_t> plane(size + 1, 0xcd);
+        extractChannel(pixels.data(), size, channels, channel, plane.data());
+        bool matches = plane[size] == 0xcd;   // nothing written past the plane
+        for (size_t pixel = 0; pixel < size; ++pixel) {
+          matches = matches && plane[pixel] == pixels[channels * pixel + channel];
+        }
+        check(matches, "extractChannel", size);
+      }
+    }
+  }
+}
+
+int main() {
+  std::mt19937 random(1234);
+  ThreadPool pool(4);
+  testFlattenTriangles(random);
+  testSplitMesh(pool);
+  testHashBytes(random);
+  testSimilarityTransform(random);
+  testMortonOrder(random, pool);
+  testQuantizeNormalized(random);
+  testPackTangents(random);
+  testSmoothNormals(pool);
+  testTangents(pool);
+  testWeldMesh(pool);
+  testMergePlacedMeshes(random, pool);
+  testClusterMesh(pool);
+  testSimplifyMesh(pool);
+  testThreadCountIndependence();
+  testGrowBounds(random);
+  testOffsetPoints(random);
+  testExtractChannel(random);
+  std::cerr << (BRIDGE_HAS_GATHER_KERNEL ? "AVX2" : "scalar") << " kernels: " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}